@@ -232,6 +232,18 @@ const char shelp[]		PROGMEM = "HELP";
 const char sshl[]		PROGMEM = "<<";
 const char sshr[]		PROGMEM = ">>";
 const char sbit[]		PROGMEM = "BIT";
+#ifdef HASMATRIX
+const char smat[]		PROGMEM = "MAT";
+const char szer[]		PROGMEM = "ZER";
+const char scon[]		PROGMEM = "CON";
+const char ssum[]		PROGMEM = "SUM";
+const char smin[]		PROGMEM = "MIN";
+const char smax[]		PROGMEM = "MAX";
+#endif
+#ifdef HASCOMPACTARRAYS
+const char sbyte[]		PROGMEM = "BYTE";
+const char slong[]		PROGMEM = "LONG";
+#endif
 #ifdef HASCAMERA
 const char scam[]	PROGMEM = "CAM";
 #endif
@@ -318,6 +330,12 @@ const char* const keyword[] PROGMEM = {
   shelp,
 #endif
   sshl, sshr, sbit,
+#ifdef HASMATRIX
+  smat, szer, scon, ssum, smin, smax,
+#endif
+#ifdef HASCOMPACTARRAYS
+  sbyte, slong,
+#endif
 #ifdef HASCAMERA
   scam,
 #endif
@@ -402,6 +420,12 @@ const token_t tokens[] PROGMEM = {
   THELP,
 #endif
   TSHL, TSHR, TBIT,
+#ifdef HASMATRIX
+  TMAT, TZER, TCON, TSUM, TMIN, TMAX,
+#endif
+#ifdef HASCOMPACTARRAYS
+  TBYTE, TLONG,
+#endif
 #ifdef HASCAMERA
   TCAM,
 #endif
@@ -492,6 +516,9 @@ const number_t maxnum = 16777216;
 #else
 const number_t maxnum = (number_t)~((number_t)1 << (sizeof(number_t) * 8 - 1));
 #endif
+#ifdef HASINTEGERPATH
+const exint_t intmax = maxnum;
+#endif
 const int numsize = sizeof(number_t);
 const int addrsize = sizeof(address_t);
 const int eheadersize = sizeof(address_t) + 1;
@@ -572,6 +599,18 @@ address_t here;
 /* the topmost byte of a program in memory, beginning of free BASIC RAM */
 address_t top;
 
+/* 
+  dynamic strings are in a pool from strpool to strpooltop, right above the 
+  program, free BASIC RAM begins after the pool then 
+*/
+#ifdef HASDYNAMICSTRINGS
+address_t strpool = 0;
+address_t strpooltop = 0;
+#define FREERAM strpooltop
+#else
+#define FREERAM top
+#endif
+
 /* used to format output with # */
 mem_t form = 0;
 
@@ -663,6 +702,45 @@ mem_t lexliteral = 0;
 heap_t bfind_object;
 #endif
 
+/*
+   The heap index, an open addressed hash table of the header addresses
+   of all visible heap objects. heapindexshadow counts objects hidden by a
+   newer one with the same name, heapindexfull is set if the table overflows.
+*/
+#if defined(HASAPPLE1) && defined(HEAPINDEXSIZE) && HEAPINDEXSIZE > 0
+#if (HEAPINDEXSIZE & (HEAPINDEXSIZE - 1)) != 0
+#error "HEAPINDEXSIZE must be a power of two"
+#endif
+address_t heapindex[HEAPINDEXSIZE];
+address_t heapindexcount = 0;
+address_t heapindexshadow = 0;
+mem_t heapindexfull = 0;
+#endif
+
+/*
+   The heap cache with its hit and miss counters, they can be read
+   with USR(0,36) and USR(0,37) and are reset on RUN.
+*/
+#if defined(HASAPPLE1) && defined(HEAPCACHESIZE) && HEAPCACHESIZE > 0
+#ifndef HEAPCACHEWAYS
+#define HEAPCACHEWAYS 4
+#endif
+#define HEAPCACHESETS (HEAPCACHESIZE / HEAPCACHEWAYS)
+heap_t heapcache[HEAPCACHESIZE];
+mem_t heapcachenext[HEAPCACHESETS];
+unsigned long heapcachehits = 0;
+unsigned long heapcachemisses = 0;
+#endif
+
+/*
+   The array cache, the last resolved arrays with their payload address, 
+   number of elements and second dimension, see findarray().
+*/
+#if defined(HASAPPLE1) && defined(ARRAYCACHESIZE) && ARRAYCACHESIZE > 0
+array_t arraycache[ARRAYCACHESIZE];
+mem_t arraycachenext = 0;
+#endif
+
 /*
    a variable for string to numerical conversion,
    telling you were the number ended.
@@ -855,6 +933,10 @@ void eload() {
     a++;
     top = getaddress(a, beread);
     a += addrsize;
+    clrlineindex();
+    clrlinktable();
+    clrbraketmap();
+    clrexprcache();
 
     /* load it to memory, memwrite2 is direct mem access */
     while (a < top + eheadersize) {
@@ -875,6 +957,10 @@ char autorun() {
   if (elength() > 0 && eread(0) == 1) { /* autorun from the EEPROM */
     top = getaddress(1, beread);
     st = SERUN;
+    clrlineindex();
+    clrlinktable();
+    clrbraketmap();
+    clrexprcache();
     return 1; /* EEPROM autorun overrules filesystem autorun */
   }
 
@@ -918,6 +1004,217 @@ char autorun() {
 
 */
 
+/* read the header of the object at b into bfind_object, return the payload address */
+address_t bheapobject(address_t b) {
+  bfind_object.name.token = memread2(b++);
+  b = getname(b, &bfind_object.name, memread2);
+  if (bfind_object.name.token != VARIABLE) {
+    bfind_object.size = getaddress(b, memread2);
+    b += addrsize;
+  } else {
+    bfind_object.size = numsize;
+  }
+  bfind_object.address = b;
+  return b;
+}
+
+/*
+   The heap index. Instead of walking the heap in bfind() the header
+   addresses of the objects are kept in a hash table with linear probing.
+   The heap itself stays as it is, the table only points into it. An object
+   created with an existing name replaces the entry, just like the newer
+   object shadows the older one in the heap walk.
+
+   bfree() removes the freed objects from the table and counts down the
+   shadowed ones among them. Shadowed objects which become visible again
+   are looked up in the remaining heap. If the table runs full, it is
+   switched off and bfind() walks the heap until the next clrvars().
+*/
+/* a hash of type and name, used by the heap index and the heap cache */
+address_t bnamehash(name_t* name) {
+  address_t h = (unsigned char) name->token;
+#ifdef HASLONGNAMES
+  mem_t l;
+  h = h * 31 + name->l;
+  for (l = 0; l < name->l; l++) h = h * 31 + (unsigned char) name->c[l];
+#else
+  h = h * 31 + (unsigned char) name->c[0];
+  h = h * 31 + (unsigned char) name->c[1];
+#endif
+  return h;
+}
+
+#if defined(HEAPINDEXSIZE) && HEAPINDEXSIZE > 0
+address_t heapindexhash(name_t* name) {
+  return bnamehash(name) & (HEAPINDEXSIZE - 1);
+}
+
+/* the key of a heap object, type and name */
+address_t heapindexkey(address_t b, name_t* name) {
+  name->token = memread2(b);
+  (void) getname(b + 1, name, memread2);
+  return heapindexhash(name);
+}
+
+/* the slot of the name or the empty slot where it would be inserted */
+address_t heapindexslot(name_t* name) {
+  address_t i;
+  name_t n;
+
+  i = heapindexhash(name);
+  while (heapindex[i]) {
+    (void) heapindexkey(heapindex[i], &n);
+    if (name->token == n.token && cmpname(name, &n)) break;
+    i = (i + 1) & (HEAPINDEXSIZE - 1);
+  }
+  return i;
+}
+
+void clrheapindex() {
+  address_t i;
+
+  for (i = 0; i < HEAPINDEXSIZE; i++) heapindex[i] = 0;
+  heapindexcount = 0;
+  heapindexshadow = 0;
+  heapindexfull = 0;
+}
+
+/* enter the header address b of an object, newer objects replace older ones */
+void addheapindex(name_t* name, address_t b, mem_t replace) {
+  address_t i;
+
+  if (heapindexfull) return;
+
+  i = heapindexslot(name);
+  if (heapindex[i]) {
+    heapindexshadow++;
+    if (replace) heapindex[i] = b;
+    return;
+  }
+
+  /* keep the table at most three quarters full */
+  if (heapindexcount >= HEAPINDEXSIZE / 4 * 3) {
+    heapindexfull = 1;
+    return;
+  }
+  heapindex[i] = b;
+  heapindexcount++;
+}
+
+/* remove a slot, the following entries of the cluster are moved back */
+void delheapindex(address_t i) {
+  address_t j, k;
+  name_t n;
+
+  j = i;
+  while (1) {
+    j = (j + 1) & (HEAPINDEXSIZE - 1);
+    if (!heapindex[j]) break;
+    k = heapindexkey(heapindex[j], &n);
+    if ((i <= j) ? (i < k && k <= j) : (i < k || k <= j)) continue;
+    heapindex[i] = heapindex[j];
+    i = j;
+  }
+  heapindex[i] = 0;
+  heapindexcount--;
+}
+
+/* rebuild the index walking the heap from the newest object */
+void rebuildheapindex() {
+  address_t b;
+
+  clrheapindex();
+  b = himem + 1;
+  while (b <= memsize && !heapindexfull) {
+    (void) bheapobject(b);
+    addheapindex(&bfind_object.name, b, 0);
+    b = bfind_object.address + bfind_object.size;
+    if (b <= bfind_object.address && bfind_object.size) break;
+  }
+  zeroheap(&bfind_object);
+}
+
+/*
+   after a bfree() at most r shadowed objects become visible, the newest
+   object of a name without an index entry is the one to enter
+*/
+void revealheapindex(address_t r) {
+  address_t b, s;
+
+  b = himem + 1;
+  while (b <= memsize && r && heapindexshadow) {
+    (void) bheapobject(b);
+    s = heapindexslot(&bfind_object.name);
+    if (!heapindex[s]) {
+      heapindex[s] = b;
+      heapindexcount++;
+      heapindexshadow--;
+      r--;
+    }
+    b = bfind_object.address + bfind_object.size;
+    if (b <= bfind_object.address && bfind_object.size) break;
+  }
+  zeroheap(&bfind_object);
+}
+#else
+void clrheapindex() {}
+#endif
+
+/*
+   The heap cache, a small set associative cache of found heap objects.
+   Each name maps to one set of HEAPCACHEWAYS entries, replacement in a
+   set is round robin. Without HEAPCACHESIZE, only the last found object
+   in bfind_object is used as a cache.
+*/
+#if defined(HEAPCACHESIZE) && HEAPCACHESIZE > 0
+void clrheapcache() {
+  address_t i;
+
+  for (i = 0; i < HEAPCACHESIZE; i++) zeroheap(&heapcache[i]);
+  for (i = 0; i < HEAPCACHESETS; i++) heapcachenext[i] = 0;
+}
+
+heap_t* findheapcache(name_t* name) {
+  heap_t* e;
+  mem_t w;
+
+  e = heapcache + (bnamehash(name) % HEAPCACHESETS) * HEAPCACHEWAYS;
+  for (w = 0; w < HEAPCACHEWAYS; w++, e++)
+    if (name->token == e->name.token && cmpname(name, &e->name)) return e;
+  return 0;
+}
+
+/* an existing entry of the same name is replaced, needed for shadowing objects */
+void addheapcache(heap_t* object) {
+  heap_t* e;
+  address_t s;
+
+  if (!(e = findheapcache(&object->name))) {
+    s = bnamehash(&object->name) % HEAPCACHESETS;
+    e = heapcache + s * HEAPCACHEWAYS + heapcachenext[s];
+    heapcachenext[s] = (heapcachenext[s] + 1) % HEAPCACHEWAYS;
+  }
+  *e = *object;
+}
+#else
+void clrheapcache() {}
+#endif
+
+/*
+   The array cache is cleared whenever the heap cache is and on every 
+   new array, a DIM may hide an array with the same name.
+*/
+#if defined(ARRAYCACHESIZE) && ARRAYCACHESIZE > 0
+void clrarraycache() {
+  mem_t i;
+
+  for (i = 0; i < ARRAYCACHESIZE; i++) arraycache[i].name.token = 0;
+  arraycachenext = 0;
+}
+#else
+void clrarraycache() {}
+#endif
+
 address_t bmalloc(name_t* name, address_t l) {
   address_t payloadsize;     /* the payload size */
   address_t heapheadersize = sizeof(name_t) + addrsize; /* this is only used to estimate the free space, it is the maximum */
@@ -948,6 +1245,17 @@ address_t bmalloc(name_t* name, address_t l) {
       payloadsize = numsize * l + addrsize;
       break;
 #endif
+#ifdef HASCOMPACTARRAYS
+    case TBYTE: /* compact arrays are like arrays with smaller elements */
+    case TINT:
+    case TLONG:
+#ifndef HASMULTIDIM
+      payloadsize = elementsize(name->token) * l;
+#else
+      payloadsize = elementsize(name->token) * l + addrsize;
+#endif
+      break;
+#endif
 #ifdef HASDARTMOUTH
     case TFN: /* the jump address, the type of function/type of return value, the number of vars
 			and all variables are stored*/
@@ -961,7 +1269,7 @@ address_t bmalloc(name_t* name, address_t l) {
 
   /* enough memory ?, on an EEPROM system we limit the heap to the RAM */
 #ifndef EEPROMMEMINTERFACE
-  if ((himem - top) < payloadsize + heapheadersize) {
+  if ((himem - FREERAM) < payloadsize + heapheadersize) {
     error(EOUTOFMEMORY);
     return 0;
   }
@@ -995,7 +1303,7 @@ address_t bmalloc(name_t* name, address_t l) {
   memwrite2(b--, name->token);
 
   /* if anything went wrong we exit here without changing himem */
-  if (b < top || er) {
+  if (b < FREERAM || er) {
     error(EOUTOFMEMORY);
     return 0;
   }
@@ -1007,6 +1315,17 @@ address_t bmalloc(name_t* name, address_t l) {
   /* himem is the next free byte now again */
   himem = b;
 
+  /* a new array of any type may shadow a resolved one of the same name */
+  if (name->token != VARIABLE && name->token != STRINGVAR) clrarraycache();
+
+  /* the new object goes to the index */
+#if defined(HEAPINDEXSIZE) && HEAPINDEXSIZE > 0
+  addheapindex(name, himem + 1, 1);
+#endif
+#if defined(HEAPCACHESIZE) && HEAPCACHESIZE > 0
+  addheapcache(&bfind_object);
+#endif
+
   if (DEBUG) {
     outsc("** bmalloc returns "); outnumber(bfind_object.address);
     outsc(" himem is "); outnumber(himem); outcr();
@@ -1018,7 +1337,12 @@ address_t bmalloc(name_t* name, address_t l) {
 
 address_t bfind(name_t* name) {
   address_t b, b0;
-  address_t i = 0;
+#if defined(HEAPINDEXSIZE) && HEAPINDEXSIZE > 0
+  address_t i;
+#endif
+#if defined(HEAPCACHESIZE) && HEAPCACHESIZE > 0
+  heap_t* e;
+#endif
 
   /* Initial DEBUG message. */
   if (DEBUG) {
@@ -1031,7 +1355,13 @@ address_t bfind(name_t* name) {
   if (himem == memsize) return 0; else b = himem + 1;
 
   /* we have the object already in cache and return */
+#if defined(HEAPCACHESIZE) && HEAPCACHESIZE > 0
+  if ((e = findheapcache(name))) {
+    heapcachehits++;
+    bfind_object = *e;
+#else
   if (name->token == bfind_object.name.token && cmpname(name, &bfind_object.name)) {
+#endif
     if (DEBUG) {
       outsc("*** bfind found in cache ");
       outname(name);
@@ -1041,36 +1371,31 @@ address_t bfind(name_t* name) {
     }
     return bfind_object.address;
   }
+#if defined(HEAPCACHESIZE) && HEAPCACHESIZE > 0
+  heapcachemisses++;
+#endif
+
+  /* look into the index, if it is complete a miss means there is no object */
+#if defined(HEAPINDEXSIZE) && HEAPINDEXSIZE > 0
+  if (!heapindexfull) {
+    i = heapindexslot(name);
+    if (heapindex[i]) {
+      (void) bheapobject(heapindex[i]);
+      goto found;
+    }
+    zeroheap(&bfind_object);
+    return 0;
+  }
+#endif
 
   /* walk through the heap from the last object added to the first */
   while (b <= memsize) {
 
-    /* get the name and the type and advance */
-    bfind_object.name.token = memread2(b++);
-    b = getname(b, &bfind_object.name, memread2);
-
-    /* determine the size of the object and advance */
-    if (bfind_object.name.token != VARIABLE) {
-      bfind_object.size = getaddress(b, memread2);
-      b += addrsize;
-    } else {
-      bfind_object.size = numsize;
-    }
-
-    /* this is the location of the payload */
-    bfind_object.address = b;
+    /* get the header of the object and advance to the payload */
+    b = bheapobject(b);
 
     /* have we found the object */
-    if (name->token == bfind_object.name.token && cmpname(name, &bfind_object.name)) {
-      if (DEBUG) {
-        outsc("*** bfind found ");
-        outname(name);
-        outsc(" at ");
-        outnumber(bfind_object.address);
-        outcr();
-      }
-      return bfind_object.address;
-    }
+    if (name->token == bfind_object.name.token && cmpname(name, &bfind_object.name)) goto found;
 
     /* advance on the heap */
     b0 = b;
@@ -1092,12 +1417,29 @@ address_t bfind(name_t* name) {
   }
   zeroheap(&bfind_object);
   return 0;
+
+  /* the object is in bfind_object, remember it in the cache */
+found:
+  if (DEBUG) {
+    outsc("*** bfind found ");
+    outname(name);
+    outsc(" at ");
+    outnumber(bfind_object.address);
+    outcr();
+  }
+#if defined(HEAPCACHESIZE) && HEAPCACHESIZE > 0
+  addheapcache(&bfind_object);
+#endif
+  return bfind_object.address;
 }
 
 /* reimplementation bfree with name interface */
 address_t bfree(name_t* name) {
-  address_t b;
+  address_t b, e;
   address_t i;
+#if defined(HEAPINDEXSIZE) && HEAPINDEXSIZE > 0
+  address_t s, r = 0;
+#endif
 
   if (DEBUG) {
     outsc("*** bfree called for ");
@@ -1119,11 +1461,37 @@ address_t bfree(name_t* name) {
     outcr();
   }
 
+  /* the freed object and all newer ones leave the index, r counts the visible ones */
+  e = b + bfind_object.size - 1;
+#if defined(HEAPINDEXSIZE) && HEAPINDEXSIZE > 0
+  if (!heapindexfull) {
+    for (i = himem + 1; i <= e; i = bfind_object.address + bfind_object.size) {
+      (void) bheapobject(i);
+      s = heapindexslot(&bfind_object.name);
+      if (heapindex[s] == i) {
+        delheapindex(s);
+        r++;
+      } else if (heapindexshadow) heapindexshadow--;
+    }
+  }
+#endif
+
+  /* the strings of freed descriptors are garbage now */
+#ifdef HASDYNAMICSTRINGS
+  freestrings(himem + 1, e);
+#endif
+
   /* clear the entire memory area */
-  for (i = himem; i <= b + bfind_object.size - 1; i++) memwrite2(i, 0);
+  for (i = himem; i <= e; i++) memwrite2(i, 0);
 
   /* set the number of variables to the new value */
-  himem = b + bfind_object.size - 1;
+  himem = e;
+
+  /* shadowed objects may become visible again, a full index is rebuilt */
+#if defined(HEAPINDEXSIZE) && HEAPINDEXSIZE > 0
+  if (heapindexfull) rebuildheapindex();
+  else if (heapindexshadow && r) revealheapindex(r);
+#endif
 
   if (DEBUG) {
     outsc("** bfree returns ");
@@ -1133,6 +1501,8 @@ address_t bfree(name_t* name) {
 
   /* forget the chache, because heap structure has changed !! */
   zeroheap(&bfind_object);
+  clrheapcache();
+  clrarraycache();
   return himem;
 }
 
@@ -1174,7 +1544,7 @@ number_t getvar(name_t *name) {
       case 'E':
         return elength() / numsize;
       case 0:
-        return (himem - top) / numsize;
+        return (himem - FREERAM) / numsize;
       case 'R':
         return rd;
 #ifdef HASSTEFANSEXT
@@ -1333,9 +1703,18 @@ void clrvars() {
   /* reset the heap start*/
   himem = memsize;
 
-  /* and clear the cache */
+  /* and the string pool */
+#ifdef HASDYNAMICSTRINGS
+  strzeroblock(strpool, strpooltop - strpool);
+  strpool = strpooltop = top;
+#endif
+
+  /* and clear the cache and the index */
 #ifdef HASAPPLE1
   zeroheap(&bfind_object);
+  clrheapcache();
+  clrarraycache();
+  clrheapindex();
 #endif
 }
 
@@ -1364,11 +1743,56 @@ void beupdate(address_t a, mem_t v) {
 }
 
 
+/*
+   If BASIC memory is a plain array, the readers and writers of mem
+   copy the bytes in one go instead of calling f for each byte. memread
+   only reads mem if we don't run from EEPROM. All other memory goes 
+   byte by byte through f.
+
+   memgetnumber(), memgetaddress() and memgetname() are the RAM backend.
+   They read mem directly and are small enough for the compiler to 
+   inline them. The token stream uses them in gettokenram().
+*/
+#if !defined(USEMEMINTERFACE) && !defined(EEPROMMEMINTERFACE)
+#define HASDIRECTMEM
+#define DIRECTREAD(f) ((f) == memread2 || ((f) == memread && st != SERUN))
+#define DIRECTWRITE(f) ((f) == memwrite2)
+
+number_t memgetnumber(address_t m) {
+  number_t v;
+
+  memcpy(&v, &mem[m], sizeof(number_t));
+  return v;
+}
+
+address_t memgetaddress(address_t m) {
+  address_t a;
+
+  memcpy(&a, &mem[m], sizeof(address_t));
+  return a;
+}
+
+address_t memgetname(address_t m, name_t* name) {
+#ifndef HASLONGNAMES
+  name->c[0] = mem[m++];
+  name->c[1] = mem[m++];
+#else
+  name->l = mem[m++];
+  memcpy(name->c, &mem[m], name->l);
+  m += name->l;
+#endif
+  return m;
+}
+#endif
+
 /* a generic memory reader for numbers  */
 number_t getnumber(address_t m, memreader_t f) {
   mem_t i;
   accu_t z;
 
+#ifdef HASDIRECTMEM
+  if (DIRECTREAD(f)) return memgetnumber(m);
+#endif
   for (i = 0; i < numsize; i++) z.c[i] = f(m++);
   return z.n;
 }
@@ -1378,6 +1802,9 @@ address_t getaddress(address_t m, memreader_t f) {
   mem_t i;
   accu_t z;
 
+#ifdef HASDIRECTMEM
+  if (DIRECTREAD(f)) return memgetaddress(m);
+#endif
   for (i = 0; i < addrsize; i++) z.c[i] = f(m++);
   return z.a;
 }
@@ -1388,6 +1815,12 @@ stringlength_t getstrlength(address_t m, memreader_t f) {
   accu_t z;
 
   z.a = 0;
+#ifdef HASDIRECTMEM
+  if (DIRECTREAD(f)) {
+    memcpy(&z.s, &mem[m], sizeof(stringlength_t));
+    return z.s;
+  }
+#endif
   for (i = 0; i < strindexsize; i++) z.c[i] = f(m++);
   return z.a;
 }
@@ -1397,6 +1830,12 @@ void setnumber(address_t m, memwriter_t f, number_t v) {
   mem_t i;
   accu_t z;
 
+#ifdef HASDIRECTMEM
+  if (DIRECTWRITE(f)) {
+    memcpy(&mem[m], &v, sizeof(number_t));
+    return;
+  }
+#endif
   z.n = v;
   for (i = 0; i < numsize; i++) f(m++, z.c[i]);
 }
@@ -1406,6 +1845,12 @@ void setaddress(address_t m, memwriter_t f, address_t a) {
   mem_t i;
   accu_t z;
 
+#ifdef HASDIRECTMEM
+  if (DIRECTWRITE(f)) {
+    memcpy(&mem[m], &a, sizeof(address_t));
+    return;
+  }
+#endif
   z.a = a;
   for (i = 0; i < addrsize; i++) f(m++, z.c[i]);
 }
@@ -1415,6 +1860,12 @@ void setstrlength(address_t m, memwriter_t f, stringlength_t s) {
   mem_t i;
   accu_t z;
 
+#ifdef HASDIRECTMEM
+  if (DIRECTWRITE(f)) {
+    memcpy(&mem[m], &s, sizeof(stringlength_t));
+    return;
+  }
+#endif
   z.s = s;
   for (i = 0; i < strindexsize; i++) f(m++, z.c[i]);
 }
@@ -1572,6 +2023,110 @@ void outname(name_t* name) {
    0-n elements like in Microsoft BASIC.
 
 */
+/* the element size of number arrays and compact arrays */
+mem_t elementsize(token_t t) {
+  switch (t) {
+#ifdef HASCOMPACTARRAYS
+    case TBYTE:
+      return 1;
+    case TINT:
+      return 2;
+    case TLONG:
+      return 4;
+#endif
+    default:
+      return numsize;
+  }
+}
+
+#ifdef HASCOMPACTARRAYS
+/*
+   Compact arrays store bytes from 0 to 255 (BYTE), 16 bit (INT) 
+   and 32 bit (LONG) signed integers. Their heap token is the type 
+   keyword, an array name can belong to any of them or to a number 
+   array. Elements are stored with the low byte first. Numbers are 
+   truncated on assignment, a value outside of the type is a range 
+   error.
+*/
+
+/* find a compact array with the name of a number array, the type is in bfind_object */
+address_t findcompact(name_t* variable) {
+  name_t n = *variable;
+  address_t a;
+
+  n.token = TBYTE;
+  if ((a = bfind(&n))) return a;
+  n.token = TINT;
+  if ((a = bfind(&n))) return a;
+  n.token = TLONG;
+  return bfind(&n);
+}
+
+/* is the array name already used by an array of another type */
+mem_t arraytypeclash(name_t* variable) {
+  name_t n = *variable;
+
+  n.token = ARRAYVAR;
+  if (variable->token == ARRAYVAR) return findcompact(&n) != 0;
+  if (bfind(&n)) return 1;
+  n.token = TBYTE;
+  if (variable->token != TBYTE && bfind(&n)) return 1;
+  n.token = TINT;
+  if (variable->token != TINT && bfind(&n)) return 1;
+  n.token = TLONG;
+  return variable->token != TLONG && bfind(&n);
+}
+
+/* read an element of an array of type t */
+number_t getelement(address_t a, token_t t) {
+  uint32_t u;
+
+  switch (t) {
+    case TBYTE:
+      return (unsigned char) memread2(a);
+    case TINT:
+      u = (unsigned char) memread2(a) | (uint32_t) (unsigned char) memread2(a + 1) << 8;
+      return (int16_t) u;
+    case TLONG:
+      u = (unsigned char) memread2(a) | (uint32_t) (unsigned char) memread2(a + 1) << 8;
+      u |= (uint32_t) (unsigned char) memread2(a + 2) << 16 | (uint32_t) (unsigned char) memread2(a + 3) << 24;
+      return (int32_t) u;
+    default:
+      return getnumber(a, memread2);
+  }
+}
+
+/* write an element of an array of type t */
+void setelement(address_t a, token_t t, number_t v) {
+  uint32_t u;
+
+  switch (t) {
+    case TBYTE:
+      if (v <= -1 || v >= 256) break;
+      memwrite2(a, (int) v);
+      return;
+    case TINT:
+      if (v <= -32769.0 || v >= 32768.0) break;
+      u = (int32_t) v;
+      memwrite2(a, u);
+      memwrite2(a + 1, u >> 8);
+      return;
+    case TLONG:
+      if (v <= -2147483649.0 || v >= 2147483648.0) break;
+      u = (int32_t) v;
+      memwrite2(a, u);
+      memwrite2(a + 1, u >> 8);
+      memwrite2(a + 2, u >> 16);
+      memwrite2(a + 3, u >> 24);
+      return;
+    default:
+      setnumber(a, memwrite2, v);
+      return;
+  }
+  error(EORANGE);
+}
+#endif
+
 address_t createarray(name_t* variable, address_t i, address_t j) {
   address_t a;
 
@@ -1595,9 +2150,10 @@ address_t createarray(name_t* variable, address_t i, address_t j) {
 
   /* allocate the array space */
   a = bmalloc(variable, i * j);
+  if (!USELONGJUMP && er) return 0;
 
-  /* store the dimension of the array at the beginning of the array area */
-  setaddress(a + i * j * numsize, memwrite2, j);
+  /* store the dimension of the array at the end of the array area */
+  setaddress(a + i * j * elementsize(variable->token), memwrite2, j);
 
   /* return value is the address of the payload area */
   return a;
@@ -1606,34 +2162,186 @@ address_t createarray(name_t* variable, address_t i, address_t j) {
   return 0;
 }
 
+#ifdef HASMULTIDIM
 /*
-   The array function.
+   Arrays with more than two dimensions, d holds the n extents. The 
+   elements are stored row major as in two dimensional arrays. After 
+   them comes the dimension table with all extents but the first, the 
+   number of dimensions and a zero word. Two dimensional arrays end with 
+   the second extent which is never zero, this tells them apart.
+
+   bmalloc() counts arrays in elements, hence the table is rounded up to 
+   whole elements and findarray() reads it from the end of the payload.
+*/
+address_t createmultiarray(name_t* variable, address_t* d, mem_t n) {
+  address_t a, t;
+  address_t e = 1; /* the number of elements */
+  mem_t s = elementsize(variable->token);
+  mem_t k;
+
+  for (k = 0; k < n; k++) {
+    if (msarraylimits) d[k] += 1;
+    if (e > memsize / d[k]) {
+      error(EOUTOFMEMORY);
+      return 0;
+    }
+    e *= d[k];
+  }
 
-   We use the lefthandside object here with the convention that i is the first index
-   and j the second index. This is inconsistent with the use in strings. Will be fixed
-   when a true indexing type is introduced.
-*/
-void array(lhsobject_t* object, mem_t getset, number_t* value) {
-  address_t a; /* the address of the array element */
-  address_t h; /* the number of elements in the array */
-  address_t l = arraylimit; /* the lower limit, defaults to the arraylimit, here for further use */
-  address_t dim = 1; /* the array dimension */
+  /* the bytes of the elements and the table have to fit as well */
+  if (e > memsize / s - (n * addrsize + s - 1) / s) {
+    error(EOUTOFMEMORY);
+    return 0;
+  }
 
   if (DEBUG) {
-    outsc("* array: accessing ");
-    outname(&name); outspc(); outspc();
-    outnumber(object->i); outspc();
-    outnumber(object->j); outspc();
-    outsc(" getset "); outch(getset); outcr();
+    outsc("* create multidim array "); outname(variable); outspc();
+    outnumber(n); outspc(); outnumber(e); outcr();
   }
 
-  /* handling the special array, range check and access is done here */
-  if (object->name.c[0] == '@') {
-    switch (object->name.c[1]) {
-      /* @E ranges from 1 to the end of the EEPROM minus the header */
-      case 'E':
-        h = elength() / numsize;
-        a = elength() - numsize * object->i;
+  /* bmalloc reserves one address word, we need n more */
+  a = bmalloc(variable, e + (n * addrsize + s - 1) / s);
+  if (!USELONGJUMP && er) return 0;
+
+  /* the table at the end of the payload */
+  t = a + bfind_object.size - (n + 1) * addrsize;
+  for (k = 1; k < n; k++, t += addrsize) setaddress(t, memwrite2, d[k]);
+  setaddress(t, memwrite2, n);
+  setaddress(t + addrsize, memwrite2, 0);
+
+  return a;
+}
+#endif
+
+/*
+   Find an array, return the payload address and fill the array object 
+   with the number of elements, the row length and the dimension table. 
+   Undefined arrays are created with the default size. Multidim reserves 
+   one address word for the second dimension at the end of the payload, 
+   hence we have less bytes for the elements. Arrays with more dimensions 
+   end with a zero word, see createmultiarray(). The row length of them 
+   is the product of all dimensions but the first, code which only 
+   knows two dimensions sees them as a matrix of this row length.
+
+   Resolved arrays are remembered in the array cache, a hit saves the 
+   heap search, the division and reading the dimension.
+*/
+#ifdef HASAPPLE1
+address_t findarray(name_t* variable, array_t* object) {
+  address_t a;
+#ifdef HASMULTIDIM
+  address_t t;
+  mem_t k;
+#endif
+#if defined(ARRAYCACHESIZE) && ARRAYCACHESIZE > 0
+  array_t* e;
+
+  for (e = arraycache; e < arraycache + ARRAYCACHESIZE; e++)
+    if (e->name.token == variable->token && cmpname(variable, &e->name)) {
+      *object = *e;
+      return e->address;
+    }
+#endif
+
+  if (!(a = bfind(variable))) {
+#ifdef HASCOMPACTARRAYS
+    a = findcompact(variable);
+#endif
+    if (!a) a = createarray(variable, ARRAYSIZEDEF, 1);
+  }
+  if (!USELONGJUMP && er) return 0;
+  object->type = bfind_object.name.token;
+  object->esize = elementsize(object->type);
+#ifndef HASMULTIDIM
+  object->size = bfind_object.size / object->esize;
+  object->dim = 1;
+  object->dims = 1;
+  object->table = 0;
+#else
+  object->dims = 2;
+  object->table = a + bfind_object.size - addrsize;
+  object->dim = getaddress(object->table, memread2);
+  if (object->dim == 0) {
+    object->dims = getaddress(object->table - addrsize, memread2);
+    object->table -= object->dims * addrsize;
+    for (object->dim = 1, k = 0, t = object->table; k < object->dims - 1; k++, t += addrsize)
+      object->dim *= getaddress(t, memread2);
+  }
+  object->size = (object->table - a) / object->esize;
+#endif
+  object->name = *variable;
+  object->address = a;
+
+#if defined(ARRAYCACHESIZE) && ARRAYCACHESIZE > 0
+  arraycache[arraycachenext] = *object;
+  arraycachenext = (arraycachenext + 1) % ARRAYCACHESIZE;
+#endif
+  return a;
+}
+
+#ifdef HASMULTIDIM
+/*
+   Fold the second and all further indices of an array with the 
+   dimension table into the column of the row, the stride of each 
+   dimension is the product of the ones after it. Indices not given 
+   are the lower limit, dimensions not stored have the extent 1, 
+   like this a two dimensional array can be accessed with one index
+   as before. Return the column plus the lower limit for array().
+*/
+address_t arraycolumn(lhsobject_t* object, array_t* e, address_t l) {
+  address_t c = 0;
+  address_t d, x;
+  mem_t k, n;
+
+  n = (e->dims > object->dims) ? e->dims : object->dims;
+  for (k = 1; k < n; k++) {
+    if (k < e->dims) d = getaddress(e->table + (k - 1) * addrsize, memread2); else d = 1;
+    if (k >= object->dims) x = l; else if (k == 1) x = object->j; else x = object->k[k - 2];
+    if (x < l || x >= d + l) {
+      error(EORANGE);
+      return 0;
+    }
+    c = c * d + (x - l);
+  }
+  return c + l;
+}
+#endif
+#endif
+
+/*
+   The array function.
+
+   We use the lefthandside object here with the convention that i is the first index
+   and j the second index. This is inconsistent with the use in strings. Will be fixed
+   when a true indexing type is introduced.
+*/
+void array(lhsobject_t* object, mem_t getset, number_t* value) {
+  address_t a; /* the address of the array element */
+  address_t h; /* the number of elements in the array */
+  address_t l = arraylimit; /* the lower limit, defaults to the arraylimit, here for further use */
+  address_t dim = 1; /* the array dimension */
+#ifdef HASMULTIDIM
+  address_t j = l; /* the column, the second index or all further indices folded */
+#endif
+#ifdef HASAPPLE1
+  array_t e; /* the array found on the heap */
+#endif
+
+  if (DEBUG) {
+    outsc("* array: accessing ");
+    outname(&name); outspc(); outspc();
+    outnumber(object->i); outspc();
+    outnumber(object->j); outspc();
+    outsc(" getset "); outch(getset); outcr();
+  }
+
+  /* handling the special array, range check and access is done here */
+  if (object->name.c[0] == '@') {
+    switch (object->name.c[1]) {
+      /* @E ranges from 1 to the end of the EEPROM minus the header */
+      case 'E':
+        h = elength() / numsize;
+        a = elength() - numsize * object->i;
         if (a < eheadersize || a > elength() - numsize) {
           error(EORANGE);
           return;
@@ -1665,9 +2373,9 @@ void array(lhsobject_t* object, mem_t getset, number_t* value) {
         return;
 #endif
       case 0:
-        h = (himem - top) / numsize;
+        h = (himem - FREERAM) / numsize;
         a = himem - numsize * (object->i + 1) + 1;
-        if (object->i < 0 || a < top) {
+        if (object->i < 0 || a < FREERAM) {
           error(EORANGE);
           return;
         }
@@ -1676,9 +2384,9 @@ void array(lhsobject_t* object, mem_t getset, number_t* value) {
         return;
 #ifdef HASSTEFANSEXT
       case 'M':
-        h = himem - top;
+        h = himem - FREERAM;
         a = himem - object->i;
-        if (object->i < 0 || a < top) {
+        if (object->i < 0 || a < FREERAM) {
           error(EORANGE);
           return;
         }
@@ -1712,15 +2420,10 @@ void array(lhsobject_t* object, mem_t getset, number_t* value) {
     /* dynamically allocated arrays */
 #ifdef HASAPPLE1
     object->name.token = ARRAYVAR;
-    if (!(a = bfind(&object->name))) a = createarray(&object->name, ARRAYSIZEDEF, 1);
+    a = findarray(&object->name, &e);
     if (!USELONGJUMP && er) return;
-
-    /* multidim reserves one address word for the dimension, hence we have less bytes */
-#ifndef HASMULTIDIM
-    h = bfind_object.size / numsize;
-#else
-    h = (bfind_object.size - addrsize) / numsize;
-#endif
+    h = e.size;
+    dim = e.dim;
 
     if (DEBUG) {
       outsc("** in array dynamical base address "); outnumber(a);
@@ -1729,15 +2432,17 @@ void array(lhsobject_t* object, mem_t getset, number_t* value) {
     }
 
 #ifdef HASMULTIDIM
-    dim = getaddress(a + bfind_object.size - addrsize, memread2);
     if (DEBUG) {
       outsc("** in array, second dimension is "); outnumber(dim);
-      outspc(); outnumber(a + bfind_object.size);
       outcr();
     }
-    a = a + ((object->i - l) * dim + (object->j - l)) * numsize;
+    if (e.dims > 2 || object->dims > 2) {
+      j = arraycolumn(object, &e, l);
+      if (!USELONGJUMP && er) return;
+    } else j = object->j;
+    a = a + ((object->i - l) * dim + (j - l)) * e.esize;
 #else
-    a = a + (object->i - l) * numsize;
+    a = a + (object->i - l) * e.esize;
 #endif
 #else /* no array code */
     error(EVARIABLE);
@@ -1747,7 +2452,7 @@ void array(lhsobject_t* object, mem_t getset, number_t* value) {
 
   /* range check */
 #ifdef HASMULTIDIM
-  if ( (object->j < l) || (object->j >= dim + l) || (object->i < l) || (object->i >= h / dim + l)) {
+  if ( (j < l) || (j >= dim + l) || (object->i < l) || (object->i >= h / dim + l)) {
     error(EORANGE);
     return;
   }
@@ -1759,10 +2464,486 @@ void array(lhsobject_t* object, mem_t getset, number_t* value) {
 #endif
 
   /* set or get the array */
+#ifdef HASCOMPACTARRAYS
+  if (e.type != ARRAYVAR) {
+    if (getset == 'g') *value = getelement(a, e.type);
+    else if (getset == 's') setelement(a, e.type, *value);
+    return;
+  }
+#endif
   if (getset == 'g') *value = getnumber(a, memread2);
   else if (getset == 's') setnumber(a, memwrite2, *value);
 }
 
+#ifdef HASMATRIX
+/*
+   MAT statements and the array reductions SUM, MIN and MAX.
+
+   They work on the payload of an array as createarray() allocates 
+   it, a contiguous block of numbers, so the loops run in C and not in 
+   BASIC. Arrays are named as A or A() here. Undefined arrays are 
+   created with the default size as in array(). The target of a MAT 
+   statement is created with the shape of its source.
+*/
+
+/* parse an array name, the current token is the name, leave with the next token */
+char matname(name_t* variable) {
+  if (token != VARIABLE && token != ARRAYVAR) {
+    error(EUNKNOWN);
+    return 0;
+  }
+  copyname(variable, &name);
+  variable->token = ARRAYVAR;
+  if (variable->c[0] == '@') {
+    error(EVARIABLE);
+    return 0;
+  }
+  if (token == ARRAYVAR) {
+    if (!expect('(', EUNKNOWN)) return 0;
+    if (!expect(')', EUNKNOWN)) return 0;
+  }
+  nexttoken();
+  return 1;
+}
+
+/* the i-th element of an array of any type */
+number_t matget(array_t* e, address_t i) {
+#ifdef HASCOMPACTARRAYS
+  if (e->type != ARRAYVAR) return getelement(e->address + i * e->esize, e->type);
+#endif
+  return getnumber(e->address + i * numsize, memread2);
+}
+
+void matset(array_t* e, address_t i, number_t v) {
+#ifdef HASCOMPACTARRAYS
+  if (e->type != ARRAYVAR) {
+    setelement(e->address + i * e->esize, e->type, v);
+    return;
+  }
+#endif
+  setnumber(e->address + i * numsize, memwrite2, v);
+}
+
+/* 
+ * the element wise operations on all elements, fill a with k, copy b to a, 
+ * a=b+c, a=b-c and a=b*k 
+ */
+void matcompute(token_t op, array_t* a, array_t* b, array_t* c, number_t k) {
+  address_t i, n;
+  address_t ad = a->address, bd = b->address, cd = c->address;
+  number_t v = k;
+
+  /* compact arrays element by element with conversion, number arrays in place */
+#ifdef HASCOMPACTARRAYS
+  if (a->type != ARRAYVAR || b->type != ARRAYVAR || c->type != ARRAYVAR) {
+    for (i = 0; i < a->size; i++) {
+      switch (op) {
+        case '=':
+          v = matget(b, i);
+          break;
+        case '+':
+          v = matget(b, i) + matget(c, i);
+          break;
+        case '-':
+          v = matget(b, i) - matget(c, i);
+          break;
+        case '*':
+          v = matget(b, i) * k;
+          break;
+      }
+      matset(a, i, v);
+      if (!USELONGJUMP && er) return;
+    }
+    return;
+  }
+#endif
+
+  n = a->size * numsize;
+  for (i = 0; i < n; i += numsize) {
+    switch (op) {
+      case '=':
+        v = getnumber(bd + i, memread2);
+        break;
+      case '+':
+        v = getnumber(bd + i, memread2) + getnumber(cd + i, memread2);
+        break;
+      case '-':
+        v = getnumber(bd + i, memread2) - getnumber(cd + i, memread2);
+        break;
+      case '*':
+        v = getnumber(bd + i, memread2) * k;
+        break;
+    }
+    setnumber(ad + i, memwrite2, v);
+  }
+}
+
+/* the reductions SUM, MIN, MAX on all elements */
+number_t matreduce(token_t op, array_t* a) {
+  address_t i;
+  number_t r, v;
+
+  r = matget(a, 0);
+  for (i = 1; i < a->size; i++) {
+    v = matget(a, i);
+    switch (op) {
+      case TSUM:
+        r += v;
+        break;
+      case TMIN:
+        if (v < r) r = v;
+        break;
+      case TMAX:
+        if (v > r) r = v;
+        break;
+    }
+  }
+  return r;
+}
+
+/* two arrays have the same number of dimensions and the same extents */
+mem_t matshape(array_t* a, array_t* b) {
+  mem_t k;
+
+  if (a->size != b->size || a->dim != b->dim || a->dims != b->dims) return 0;
+  for (k = 0; k + 1 < a->dims; k++)
+    if (getaddress(a->table + k * addrsize, memread2) != getaddress(b->table + k * addrsize, memread2)) return 0;
+  return 1;
+}
+
+/* create the target array a with the shape of b */
+void matcreate(name_t* a, array_t* b) {
+#ifdef HASMULTIDIM
+  address_t d[MAXDIM];
+  mem_t k;
+
+  if (b->dims > 2) {
+    d[0] = b->size / b->dim - msarraylimits;
+    for (k = 1; k < b->dims; k++) d[k] = getaddress(b->table + (k - 1) * addrsize, memread2) - msarraylimits;
+    (void) createmultiarray(a, d, b->dims);
+    return;
+  }
+#endif
+  (void) createarray(a, b->size / b->dim - msarraylimits, b->dim - msarraylimits);
+}
+
+/* 
+ * MAT A=ZER, MAT A=CON, MAT A=B, MAT A=B+C, MAT A=B-C, 
+ * MAT A=B*k and MAT A=(k)*B 
+ */
+void xmat() {
+  name_t a, b, c;
+  address_t ad;
+  array_t ae, be, ce;
+  token_t op;
+  number_t k = 0;
+
+  /* unused sources are number arrays at 0 */
+  be.address = ce.address = 0;
+  be.type = ce.type = ARRAYVAR;
+
+  /* the target array */
+  nexttoken();
+  if (!matname(&a)) return;
+  if (token != '=') {
+    error(EUNKNOWN);
+    return;
+  }
+  nexttoken();
+
+  /* the right hand side */
+  op = token;
+  switch (token) {
+    case TZER:
+    case TCON:
+      k = (token == TCON);
+      nexttoken();
+      break;
+    case '(':
+      if (!expectexpr()) return;
+      if (token != ')') {
+        error(EUNKNOWN);
+        return;
+      }
+      k = pop();
+      if (!expect('*', EUNKNOWN)) return;
+      nexttoken();
+      if (!matname(&b)) return;
+      op = '*';
+      break;
+    default:
+      if (!matname(&b)) return;
+      op = token;
+      if (token == '+' || token == '-') {
+        nexttoken();
+        if (!matname(&c)) return;
+      } else if (token == '*') {
+        if (!expectexpr()) return;
+        k = pop();
+      } else op = '=';
+  }
+  if (!termsymbol()) {
+    error(EUNKNOWN);
+    return;
+  }
+
+  /* the sources, then the target with the shape of the source */
+  if (op != TZER && op != TCON) {
+    (void) findarray(&b, &be);
+    if (!USELONGJUMP && er) return;
+    if (op == '+' || op == '-') {
+      (void) findarray(&c, &ce);
+      if (!USELONGJUMP && er) return;
+      if (!matshape(&ce, &be)) {
+        error(EORANGE);
+        return;
+      }
+    }
+    ad = bfind(&a);
+#ifdef HASCOMPACTARRAYS
+    if (!ad) ad = findcompact(&a);
+#endif
+    if (!ad) matcreate(&a, &be);
+    if (!USELONGJUMP && er) return;
+  }
+  (void) findarray(&a, &ae);
+  if (!USELONGJUMP && er) return;
+  if (op != TZER && op != TCON && !matshape(&ae, &be)) {
+    error(EORANGE);
+    return;
+  }
+
+  matcompute(op, &ae, &be, &ce, k);
+}
+
+/* SUM(A), MIN(A) and MAX(A) */
+void factormat() {
+  name_t b;
+  array_t be;
+  token_t t = token;
+
+  if (!expect('(', EUNKNOWN)) return;
+  nexttoken();
+  if (!matname(&b)) return;
+  if (token != ')') {
+    error(EUNKNOWN);
+    return;
+  }
+  (void) findarray(&b, &be);
+  if (!USELONGJUMP && er) return;
+  push(matreduce(t, &be));
+}
+#endif
+
+#ifdef HASDYNAMICSTRINGS
+/*
+   Dynamic strings. The heap only holds a descriptor for every string, 
+   its length and the offset of its bytes in the string pool. The pool 
+   is a list of chunks. A chunk begins with the address of the descriptor 
+   it belongs to and its capacity, then come the bytes of the string. 
+   Chunks nobody owns any more have the owner address 0.
+
+   New chunks are added at strpooltop, the last chunk grows in place. If 
+   there is no room left, compactstrings() moves the live strings down to 
+   the beginning of the pool and drops the garbage and unused capacity.
+   Only this moves strings, it happens when a string is assigned and 
+   reservestring() runs out of memory. Strings referenced in expressions 
+   stay where they are. 
+
+   When the program changes, parkstrings() moves the pool out of the way 
+   to the top of free memory and unparkstrings() brings it back.
+*/
+const int strdescsize = sizeof(stringlength_t) + sizeof(address_t);
+const int strchunkheader = 2 * sizeof(address_t);
+mem_t strparked = 0;
+
+/* move l bytes from s to d, the areas may overlap */
+void strmoveblock(address_t s, address_t d, address_t l) {
+#ifdef HASDIRECTMEM
+  memmove(&mem[d], &mem[s], l);
+#else
+  address_t i;
+
+  if (s < d) for (i = l; i > 0; i--) memwrite2(d + i - 1, memread2(s + i - 1));
+  else for (i = 0; i < l; i++) memwrite2(d + i, memread2(s + i));
+#endif
+}
+
+/* clear l bytes at b, free memory is kept zero for the heap */
+void strzeroblock(address_t b, address_t l) {
+#ifdef HASDIRECTMEM
+  memset(&mem[b], 0, l);
+#else
+  while (l-- > 0) memwrite2(b++, 0);
+#endif
+}
+
+/* 
+  compact the pool, only the used bytes of live strings are kept, keep is 
+  a string which is in use right now, it is moved with its chunk
+*/
+void compactstrings(string_t* keep) {
+  address_t a, d, o, c, l;
+
+  a = d = strpool;
+  while (a < strpooltop) {
+    o = getaddress(a, memread2);
+    c = getaddress(a + addrsize, memread2);
+    l = 0;
+    if (o) {
+      l = getstrlength(o, memread2);
+      if (l > c) l = c;
+      if (l == 0) setaddress(o + strindexsize, memwrite2, 0);
+    }
+    if (l) {
+      if (keep && keep->address >= a + strchunkheader && keep->address <= a + strchunkheader + c) {
+        keep->address -= a - d;
+        if (keep->ir) keep->ir -= a - d;
+      }
+      strmoveblock(a, d, strchunkheader + l);
+      setaddress(d + addrsize, memwrite2, l);
+      setaddress(o + strindexsize, memwrite2, d + strchunkheader - strpool);
+      d += strchunkheader + l;
+    }
+    a += strchunkheader + c;
+  }
+  strzeroblock(d, strpooltop - d);
+  strpooltop = d;
+}
+
+/* the strings with descriptors from b to e are freed from the heap */
+void freestrings(address_t b, address_t e) {
+  address_t a, o;
+
+  for (a = strpool; a < strpooltop; a += strchunkheader + getaddress(a + addrsize, memread2)) {
+    o = getaddress(a, memread2);
+    if (o >= b && o <= e) setaddress(a, memwrite2, 0);
+  }
+}
+
+/* the descriptor of the string j of an object, create it if needed */
+address_t stringdescriptor(name_t* name, address_t j) {
+  address_t a;
+
+  if (!(a = bfind(name))) a = createstring(name, defaultstrdim, arraylimit);
+  if (!USELONGJUMP && er) return 0;
+
+#ifdef HASMULTIDIM
+  if ((j < arraylimit) || (j >= getaddress(a + bfind_object.size - addrsize, memread2) + arraylimit)) {
+    error(EORANGE);
+    return 0;
+  }
+  a += (j - arraylimit) * strdescsize;
+#endif
+  return a;
+}
+
+/* make room for l bytes in string j, the bytes already there stay */
+void reservestring(name_t* name, address_t j, address_t l, string_t* keep) {
+  address_t d, o, c, a;
+  mem_t gc;
+
+  /* the special strings are not in the pool */
+  if (name->c[0] == '@') return;
+
+  /* the longest string the length fits in */
+  if (l != (stringlength_t) l) {
+    error(EORANGE);
+    return;
+  }
+
+  d = stringdescriptor(name, j);
+  if (!USELONGJUMP && er) return;
+
+  /* an empty pool follows the program */
+  if (strpool == strpooltop) strpool = strpooltop = top;
+
+  for (gc = 0; ; gc++) {
+    o = getaddress(d + strindexsize, memread2);
+    c = 0;
+    if (o) c = getaddress(strpool + o - addrsize, memread2);
+    if (l <= c) return;
+
+    /* the last chunk grows in place, all others get a new chunk */
+    if (o && strpool + o + c == strpooltop) {
+      if (l - c <= himem - strpooltop) {
+        setaddress(strpool + o - addrsize, memwrite2, l);
+        strpooltop += l - c;
+        return;
+      }
+    } else if (strchunkheader + l <= himem - strpooltop) break;
+
+    /* we tried everything */
+    if (gc) {
+      error(EOUTOFMEMORY);
+      return;
+    }
+    compactstrings(keep);
+  }
+
+  /* the new chunk */
+  a = strpooltop;
+  setaddress(a, memwrite2, d);
+  setaddress(a + addrsize, memwrite2, l);
+  a += strchunkheader;
+
+  /* copy the string to it, the old chunk is garbage now */
+  if (o) {
+    strmoveblock(strpool + o, a, getstrlength(d, memread2));
+    setaddress(strpool + o - strchunkheader, memwrite2, 0);
+  }
+  setaddress(d + strindexsize, memwrite2, a - strpool);
+  strpooltop = a + l;
+}
+
+/* the last chunk gives back the bytes its string does not use */
+void trimstring(name_t* name, address_t j) {
+  address_t d, o, c, l;
+
+  if (name->c[0] == '@') return;
+
+  d = stringdescriptor(name, j);
+  if (!USELONGJUMP && er) return;
+  o = getaddress(d + strindexsize, memread2);
+  if (!o) return;
+  c = getaddress(strpool + o - addrsize, memread2);
+  if (strpool + o + c != strpooltop) return;
+
+  l = getstrlength(d, memread2);
+  setaddress(strpool + o - addrsize, memwrite2, l);
+  strzeroblock(strpool + o + l, c - l);
+  strpooltop = strpool + o + l;
+}
+
+/* move the pool below himem before the program changes */
+void parkstrings() {
+  address_t l = strpooltop - strpool;
+
+  if (strparked++ || l == 0) return;
+  strmoveblock(strpool, himem + 1 - l, l);
+  strpool = himem + 1 - l;
+  strpooltop = himem + 1;
+  himem = strpool - 1;
+}
+
+/* and bring it back above the program */
+void unparkstrings() {
+  address_t l = strpooltop - strpool;
+  address_t b;
+
+  if (strparked == 0 || --strparked) return;
+  if (l) {
+    himem = strpooltop - 1;
+    strmoveblock(strpool, top, l);
+    b = top + l;
+    if (b < strpool) b = strpool;
+    strzeroblock(b, strpooltop - b);
+  }
+  strpool = top;
+  strpooltop = top + l;
+}
+#endif
+
 /*
    Create a string on the heap.
 
@@ -1787,6 +2968,24 @@ address_t createstring(name_t* variable, address_t i, address_t j) {
   /* the MS string compatibility, DIM 10 creates 11 elements */
   if (msarraylimits) j += 1;
 
+#ifdef HASDYNAMICSTRINGS
+  /* dynamic strings only have their descriptors on the heap, i is not needed */
+#ifndef HASMULTIDIM
+  j = 1;
+  a = bmalloc(variable, strdescsize);
+#else
+  a = bmalloc(variable, addrsize + j * strdescsize);
+#endif
+  if (er != 0) return 0;
+
+  /* all strings are empty and have no place in the pool */
+  strzeroblock(a, j * strdescsize);
+#ifdef HASMULTIDIM
+  setaddress(a + j * strdescsize, memwrite2, j);
+#endif
+  return a;
+#endif
+
 #ifndef HASMULTIDIM
   /* if no string arrays are in the code, we reserve the number of bytes i and space for the index */
   /* allow redimension without check right now, for local variables */
@@ -1897,7 +3096,9 @@ void getstring(string_t* strp, name_t* name, address_t b, address_t j) {
     }
 
   /* dynamically allocated strings, create on the fly */
+#ifndef HASDYNAMICSTRINGS
   if (!(ax = bfind(name))) ax = createstring(name, defaultstrdim, arraylimit);
+#endif
 
   if (DEBUG) {
     outsc("** heap address "); outnumber(ax); outcr();
@@ -1911,7 +3112,29 @@ void getstring(string_t* strp, name_t* name, address_t b, address_t j) {
   /* string creating has caused an error, typically no memoryy */
   if (!USELONGJUMP && er) return;
 
-#ifndef HASMULTIDIM
+#ifdef HASDYNAMICSTRINGS
+  /* the descriptor has the length and the offset of the string in the pool */
+  ax = stringdescriptor(name, j);
+  if (!USELONGJUMP && er) return;
+  strp->length = getstrlength(ax, memread2);
+  k = getaddress(ax + strindexsize, memread2);
+
+  /* a string without a chunk has no room yet */
+  if (k) {
+    ax = strpool + k;
+    strp->strdim = getaddress(ax - addrsize, memread2);
+  } else {
+    ax = strpooltop;
+  }
+
+  if (b < 1) {
+    error(EORANGE);
+    return;
+  }
+
+  /* there is nothing beyond the capacity of the string */
+  if (b > strp->strdim) ax += strp->strdim; else ax += b - 1;
+#elif !defined(HASMULTIDIM)
   /* the maximum length of the string */
   strp->strdim = bfind_object.size - strindexsize;
 
@@ -2035,7 +3258,10 @@ void setstringlength(name_t* name, address_t l, address_t j) {
   }
 
   /* stringdim calculation moved here */
-#ifndef HASMULTIDIM
+#ifdef HASDYNAMICSTRINGS
+  /* the length is in the descriptor */
+  stringdim = strdescsize - strindexsize;
+#elif !defined(HASMULTIDIM)
   stringdim = bfind_object.size - strindexsize;
 #else
   /* getaddress seeks the dimension of the string array directly after the payload */
@@ -2209,6 +3435,74 @@ token_t gettokenvalue(address_t i) {
 #endif
 }
 
+/*
+   The keyword index groups the keywords by their first character,
+   keeping the order of the keyword array in each group. The lexer
+   only compares the keywords starting with the character in the
+   input buffer. As the keywords are matched in the same order as
+   in the array, the first keyword matching wins as before.
+
+   The index is built from the keyword array at the first use. On
+   PROGMEM systems it would cost RAM, there the array is scanned.
+*/
+#if defined(HASKEYWORDINDEX) && !defined(ARDUINOPROGMEM)
+#define KEYWORDS (sizeof(keyword) / sizeof(keyword[0]) - 1)
+#define KEYWORDFIRST 64
+address_t keywordfirst[KEYWORDFIRST + 1];
+address_t keywordorder[KEYWORDS];
+char keywordindexvalid = 0;
+
+/* the group of a character, 64 printable uppercase chars, the rest goes to one group */
+address_t keywordgroup(char c) {
+  c = btoupper(c);
+  if (c < 32 || c >= 32 + KEYWORDFIRST) return KEYWORDFIRST - 1;
+  return c - 32;
+}
+
+/* counting sort of the keywords by first character */
+void buildkeywordindex() {
+  address_t i, c;
+
+  for (c = 0; c <= KEYWORDFIRST; c++) keywordfirst[c] = 0;
+  for (i = 0; i < KEYWORDS; i++) keywordfirst[keywordgroup(keyword[i][0]) + 1]++;
+  for (c = 0; c < KEYWORDFIRST; c++) keywordfirst[c + 1] += keywordfirst[c];
+  for (i = 0; i < KEYWORDS; i++) keywordorder[keywordfirst[keywordgroup(keyword[i][0])]++] = i;
+  for (c = KEYWORDFIRST; c > 0; c--) keywordfirst[c] = keywordfirst[c - 1];
+  keywordfirst[0] = 0;
+  keywordindexvalid = 1;
+}
+#endif
+
+/* the length of keyword k if the buffer starts with it, 0 otherwise */
+address_t matchkeyword(address_t k, char* b) {
+  address_t i;
+  char* ir = getkeyword(k);
+
+  for (i = 0; *(ir + i) != 0; i++)
+    if (*(ir + i) != btoupper(*(b + i))) return 0;
+  return i;
+}
+
+/* the first keyword the buffer starts with, the length goes to l */
+address_t findkeyword(char* b, address_t* l) {
+  address_t k;
+#if defined(HASKEYWORDINDEX) && !defined(ARDUINOPROGMEM)
+  address_t j, c;
+
+  if (!keywordindexvalid) buildkeywordindex();
+  c = keywordgroup(*b);
+  for (j = keywordfirst[c]; j < keywordfirst[c + 1]; j++) {
+    k = keywordorder[j];
+    if ((*l = matchkeyword(k, b))) return k;
+  }
+#else
+  for (k = 0; gettokenvalue(k) != 0; k++)
+    if ((*l = matchkeyword(k, b))) return k;
+#endif
+  *l = 0;
+  return 0;
+}
+
 /* print a message directly to the default outpur stream */
 void printmessage(char i) {
 #ifndef HASERRORMSG
@@ -2768,33 +4062,81 @@ address_t parsenumbern(char *c, number_t *r) {
 
 
 #ifdef HASFLOAT
-/* a poor man's atof implementation with character count */
+/*
+   Powers of ten for the number conversions in scale_t, a double or for 
+   64 bit builds a long double. 10^n is exact in a double up to n=22. 
+   SMALLPOWERTABLE builds them from 1E1, 1E2, 1E4, ... with 
+   a few multiplications instead of the full table, for the flash budget 
+   of small boards. The results are the same in the exact range.
+*/
+#ifndef SMALLPOWERTABLE
+const scale_t powtable[] = { 
+  1e0L, 1e1L, 1e2L, 1e3L, 1e4L, 1e5L, 1e6L, 1e7L, 1e8L, 1e9L, 1e10L, 1e11L,
+  1e12L, 1e13L, 1e14L, 1e15L, 1e16L, 1e17L, 1e18L, 1e19L, 1e20L, 1e21L, 1e22L 
+};
+
+scale_t powten(index_t n) {
+  scale_t p = 1;
+
+  while (n > 22) {
+    p *= powtable[22];
+    n -= 22;
+  }
+  return p * powtable[n];
+}
+#else
+const scale_t powtable[] = { 1e1L, 1e2L, 1e4L, 1e8L, 1e16L, 1e32L };
+
+scale_t powten(index_t n) {
+  scale_t p = 1;
+  mem_t i;
+
+  while (n > 63) {
+    p *= powtable[5] * powtable[5];
+    n -= 64;
+  }
+  for (i = 0; n; i++, n >>= 1) if (n & 1) p *= powtable[i];
+  return p;
+}
+#endif
+
+/*
+   Read a decimal number with character count. The significant digits 
+   are collected in an integer, then scaled by one power of ten. If the
+   digits fit the mantissa and the power is exact, this is one correctly 
+   rounded operation and the number is exact. Float numbers are scaled 
+   in float for this, everything else in scale_t.
+*/
 address_t parsenumber2(char *c, number_t *r) {
   address_t nd = 0;
-  index_t i;
-  number_t fraction = 0;
-  number_t exponent = 0;
+  uint64_t m = 0;
+  index_t n = 0;
+  index_t e = 0;
+  index_t ex = 0;
   mem_t nexp = 0;
 
-  *r = 0;
-
-  /* integer part */
-  i = parsenumber(c, r);
-  c += i;
-  nd += i;
+  /* the integer part, up to 19 significant digits */
+  while (*c >= '0' && *c <= '9') {
+    if (n < 19) {
+      m = m * 10 + *c - '0';
+      if (m) n++;
+    } else e++;
+    c++;
+    nd++;
+  }
 
   /* the fractional part */
   if (*c == '.') {
     c++;
     nd++;
-
-    i = parsenumber(c, &fraction);
-    c += i;
-    nd += i;
-
-    if (i > 0) {
-      while ((--i) >= 0) fraction = fraction / 10;
-      *r += fraction;
+    while (*c >= '0' && *c <= '9') {
+      if (n < 19) {
+        m = m * 10 + *c - '0';
+        if (m) n++;
+        e--;
+      }
+      c++;
+      nd++;
     }
   }
 
@@ -2807,13 +4149,104 @@ address_t parsenumber2(char *c, number_t *r) {
       nd++;
       nexp = 1;
     };
-    i = parsenumber(c, &exponent);
-    nd += i;
-      while ((--exponent) >= 0) if (nexp) *r = *r / 10; else *r = *r * 10;
+    while (*c >= '0' && *c <= '9') {
+      if (ex < 1000) ex = ex * 10 + *c - '0';
+      c++;
+      nd++;
+    }
+    if (nexp) e -= ex; else e += ex;
+  }
+
+  /* scale the digits */
+  if (m == 0) *r = 0;
+#ifndef HAS64BIT
+  else if (m < 16777216 && e >= -10 && e <= 10) {
+    if (e < 0) *r = (number_t)m / (number_t)powten(-e);
+    else *r = (number_t)m * (number_t)powten(e);
   }
+#endif
+  else if (e < 0) *r = (scale_t)m / powten(-e);
+  else *r = (scale_t)m * powten(e);
 
   return nd;
 }
+
+/*
+   Write the shortest decimal that parsenumber2() reads back as the 
+   same number. The digits are rounded to 1, 2, ... significant digits 
+   until the number is found again. The lexer can read all of the 
+   output, LIST uses it, so programs keep their numbers through a 
+   text SAVE and LOAD. PRINT and STR$ keep the format of writenumber2().
+*/
+#ifdef HAS64BIT
+#define MAXDIGITS 17
+#else
+#define MAXDIGITS 9
+#endif
+
+address_t writeshortest(char *c, number_t v) {
+  address_t nd, s = 0;
+  index_t p, k, ke, i, j;
+  uint64_t m;
+  number_t t;
+  char d[24];
+
+  if (v == floor(v) && fabs(v) < maxnum) return writenumber(c, v);
+  if (!isfinite(v)) {
+    c[0] = '*';
+    c[1] = 0;
+    return 1;
+  }
+  if (v < 0) {
+    c[s++] = '-';
+    v = -v;
+  }
+
+  /* the decimal exponent, 10^k <= v < 10^(k+1) */
+  k = (index_t)floor(log10(v));
+  if ((k >= 0 ? powten(k) : 1 / powten(-k)) > v) k--;
+  else if ((k >= -1 ? powten(k + 1) : 1 / powten(-k - 1)) <= v) k++;
+
+  for (p = 1; p <= MAXDIGITS; p++) {
+
+    /* p digits rounded, rounding up may add a digit */
+    i = p - 1 - k;
+    m = (uint64_t)((i >= 0 ? v * powten(i) : v / powten(-i)) + 0.5);
+    ke = k;
+    if (m >= (uint64_t)powten(p)) {
+      m /= 10;
+      ke++;
+    }
+    i = writenumber(d, m);
+    while (i > 1 && d[i - 1] == '0') i--;
+
+    /* fixed point for moderate exponents, otherwise d.dddEn */
+    nd = s;
+    if (ke >= 0 && ke < 7) {
+      for (j = 0; j <= ke; j++) c[nd++] = j < i ? d[j] : '0';
+      if (i > ke + 1) {
+        c[nd++] = '.';
+        for (; j < i; j++) c[nd++] = d[j];
+      }
+    } else if (ke < 0 && ke >= -4) {
+      c[nd++] = '0';
+      c[nd++] = '.';
+      for (j = ke + 1; j < 0; j++) c[nd++] = '0';
+      for (j = 0; j < i; j++) c[nd++] = d[j];
+    } else {
+      c[nd++] = d[0];
+      if (i > 1) c[nd++] = '.';
+      for (j = 1; j < i; j++) c[nd++] = d[j];
+      c[nd++] = 'E';
+      nd += writenumber(c + nd, ke);
+    }
+    c[nd] = 0;
+
+    parsenumber2(c + s, &t);
+    if (t == v) break;
+  }
+  return nd;
+}
 #endif
 
 /*
@@ -2945,7 +4378,7 @@ address_t tinydtostrf(number_t v, index_t p, char* c) {
 address_t writenumber2(char *c, number_t vi) {
   index_t i;
   index_t nd;
-  number_t f;
+  number_t f, r;
   index_t exponent = 0;
   mem_t eflag = 0;
   const int p = 5;
@@ -2967,22 +4400,35 @@ address_t writenumber2(char *c, number_t vi) {
     return 1;
   }
 
-  /* normalize the number and see which exponent we have to deal with */
-  f = vi;
-  while (fabs(f) < 1.0)   {
-    f = f * 10;
-    exponent--;
-  }
-  while (fabs(f) >= 10.0 - 0.00001) {
-    f = f / 10;
-    exponent++;
-  }
+  /* tinydtostrf() cuts the digits, half of the last digit rounds them */
+  r = 0.5;
+  for (i = 0; i < precision; i++) r = r / 10;
+  if (forceint) r = 0;
+  if (vi < 0) r = -r;
 
   /* there are platforms where dtostrf is broken, we do things by hand in a simple way */
 
-  if (exponent > -2 && exponent < 7) {
-    tinydtostrf(vi, precision, c);
+  /* the rounded number decides on the format, 0.0999999 carries to 0.1 */
+  f = vi + r;
+  if (fabs(f) >= 0.1 && fabs(f) < 10000000.0) {
+    tinydtostrf(f, precision, c);
   } else {
+
+    /* normalize the number and see which exponent we have to deal with */
+    f = vi;
+    while (fabs(f) < 1.0)   {
+      f = f * 10;
+      exponent--;
+    }
+    while (fabs(f) >= 10.0) {
+      f = f / 10;
+      exponent++;
+    }
+    f = f + r;
+    if (fabs(f) >= 10.0) {
+      f = f / 10;
+      exponent++;
+    }
     tinydtostrf(f, precision, c);
     eflag = 1;
   }
@@ -2995,7 +4441,9 @@ address_t writenumber2(char *c, number_t vi) {
   while (c[i] == '0' && i > 1) {
     i--;
   }
-  i++;
+
+  /* a carry to an integer like 9.999999 drops the point as well */
+  if (c[i] != '.' || eflag) i++;
 
   /* add the exponent */
   if (eflag && exponent != 0) {
@@ -3323,27 +4771,16 @@ void nexttoken() {
 
 
   /*
-   	Ir is reused here to implement string compares
-   	scanning the keyword array.
+   	findkeyword() scans the keyword array, using the keyword 
+   	index if there is one.
    	Once a keyword is detected the input buffer is advanced
    	by its length, and the token value is returned.
 
    	Keywords are an array of null terminated strings.
       They are always matched uppercase.
   */
-  k = 0;
-  while (gettokenvalue(k) != 0) {
-    ir = getkeyword(k);
-    i = 0;
-    while (*(ir + i) != 0) {
-      if (*(ir + i) != btoupper(*(bi + i))) {
-        k++;
-        i = 0;
-        break;
-      } else
-        i++;
-    }
-    if (i == 0) continue;
+  k = findkeyword(bi, &i);
+  if (i) {
     bi += i;
     token = gettokenvalue(k);
     if (token == TREM) lexliteral = 1;
@@ -3574,9 +5011,48 @@ void memwrite2(address_t a, mem_t c) {
   if (a < elength() - eheadersize) eupdate(a + eheadersize, c); else mem[a - (elength() - eheadersize)] = c;
 }
 #endif
-#endif
-#endif
-
+#endif
+#endif
+
+
+/*
+   get a token from RAM, the fast version of gettoken() for plain memory
+   without any reader function, SERUN goes through the generic code
+*/
+#ifdef HASDIRECTMEM
+void gettokenram() {
+  token = mem[here++];
+  name.token = token;
+
+#ifdef HASLONGTOKENS
+  if (token == TEXT1) {
+    token = mem[here++] - 255;
+  }
+#endif
+
+  switch (token) {
+    case LINENUMBER:
+      ax = memgetaddress(here);
+      here += addrsize;
+      break;
+    case NUMBER:
+      x = memgetnumber(here);
+      here += numsize;
+      break;
+    case ARRAYVAR:
+    case VARIABLE:
+    case STRINGVAR:
+      here = memgetname(here, &name);
+      name.token = token;
+      break;
+    case STRING:
+      sr.length = (unsigned char)mem[here++];
+      sr.ir = (char*)&mem[here];
+      sr.address = here;
+      here += sr.length;
+  }
+}
+#endif
 
 /* get a token from memory */
 void gettoken() {
@@ -3589,6 +5065,14 @@ void gettoken() {
     return;
   }
 
+  /* plain memory has its own token reader, only SERUN reads byte by byte */
+#ifdef HASDIRECTMEM
+  if (st != SERUN) {
+    gettokenram();
+    return;
+  }
+#endif
+
   /* if we have no data type we are done reading just one byte */
   token = memread(here++);
   name.token = token;
@@ -3706,8 +5190,277 @@ address_t findinlinecache(address_t l) {
 }
 #endif
 
+/*
+   The line index, a table of all line numbers and the addresses of
+   their LINENUMBER tokens sorted by line number. findline() does a
+   binary search on it. It is built lazily by findline() and kept up
+   to date by storeline(). Whenever top changes outside storeline()
+   it is rebuilt. If the program has more than LINEINDEXSIZE lines,
+   findline() falls back to the line cache and the program walk. 
+   lineindexfull then stops further attempts until top changes.
+*/
+#if defined(LINEINDEXSIZE) && LINEINDEXSIZE>0
+typedef struct {
+  address_t l;
+  address_t h;
+} lineindexentry;
+lineindexentry lineindex[LINEINDEXSIZE];
+address_t lineindexlength = 0;
+address_t lineindextop = 0;
+mem_t lineindexvalid = 0;
+mem_t lineindexfull = 0;
+
+void clrlineindex() {
+  lineindexlength = 0;
+  lineindexvalid = 0;
+  lineindexfull = 0;
+}
+
+/* the position of the first line with a number not smaller than l */
+address_t lineindexsearch(address_t l) {
+  address_t lo = 0;
+  address_t hi = lineindexlength;
+  address_t m;
+
+  while (lo < hi) {
+    m = lo + (hi - lo) / 2;
+    if (lineindex[m].l < l) lo = m + 1; else hi = m;
+  }
+  return lo;
+}
+
+/* walk through the program once and collect all lines */
+void buildlineindex() {
+  lineindexlength = 0;
+  lineindexvalid = 0;
+  lineindexfull = 0;
+  lineindextop = top;
+  here = 0;
+  while (here < top) {
+    gettoken();
+    if (token == LINENUMBER) {
+      if (lineindexlength >= LINEINDEXSIZE) {
+        lineindexfull = 1;
+        return;
+      }
+      lineindex[lineindexlength].l = ax;
+      lineindex[lineindexlength].h = here - addrsize - 1;
+      lineindexlength++;
+    }
+  }
+  lineindexvalid = 1;
+}
+
+mem_t lineindexready() {
+  if (lineindextop == top && (lineindexvalid || lineindexfull)) return lineindexvalid;
+  buildlineindex();
+  return lineindexvalid;
+}
+
+/*
+   after storeline2() has stored, replaced or deleted line l, the index
+   is corrected: the line is added or removed and all following lines
+   move by the change in length. oldtop is top before the change.
+*/
+void updatelineindex(address_t l, address_t oldtop) {
+  address_t i, j, h, oldlength, newlength;
+  mem_t found;
+
+  i = lineindexsearch(l);
+  found = (i < lineindexlength && lineindex[i].l == l);
+
+  /* the length of the line before and after the change */
+  if (found) {
+    h = lineindex[i].h;
+    oldlength = ((i + 1 < lineindexlength) ? lineindex[i + 1].h : oldtop) - h;
+  } else {
+    h = (i < lineindexlength) ? lineindex[i].h : oldtop;
+    oldlength = 0;
+  }
+  newlength = oldlength + top - oldtop;
+
+  /* the line is removed or added, shifting the entries */
+  if (found && newlength == 0) {
+    for (j = i; j + 1 < lineindexlength; j++) lineindex[j] = lineindex[j + 1];
+    lineindexlength--;
+  } else if (!found) {
+    if (lineindexlength >= LINEINDEXSIZE) {
+      clrlineindex();
+      return;
+    }
+    for (j = lineindexlength; j > i; j--) lineindex[j] = lineindex[j - 1];
+    lineindexlength++;
+    lineindex[i].l = l;
+    lineindex[i].h = h;
+  }
+
+  /* the following lines have moved */
+  if (!(found && newlength == 0)) i++;
+  for (j = i; j < lineindexlength; j++) lineindex[j].h += newlength - oldlength;
+
+  lineindextop = top;
+}
+#else
+void clrlineindex() {}
+#endif
+
+/*
+   The link table, built by RUN. For every constant branch target in the
+   program, the address of the NUMBER token holding the line number is
+   mapped to the line address. These are the arguments of GOTO, GOSUB,
+   THEN, ELSE, ON GOTO/GOSUB if all elements of the list are constants,
+   and of the GOTO/GOSUB of AFTER, EVERY and EVENT. The program itself is
+   unchanged, LIST and SAVE are not affected.
+
+   The table is an open addressed hash, it needs the line index for the
+   targets. It becomes invalid with any change of the program.
+*/
+#if defined(LINKTABLESIZE) && LINKTABLESIZE>0 && defined(LINEINDEXSIZE) && LINEINDEXSIZE>0
+#define HASLINKTABLE
+#if (LINKTABLESIZE & (LINKTABLESIZE - 1)) != 0
+#error "LINKTABLESIZE must be a power of two"
+#endif
+typedef struct {
+  address_t source;
+  address_t target;
+  address_t line;
+} linkentry;
+linkentry linktable[LINKTABLESIZE];
+address_t linktablelength = 0;
+address_t linktabletop = 0;
+mem_t linktablevalid = 0;
+
+/* the stored targets of timers and events are cleared as well */
+void clrlinktable() {
+  address_t i;
+
+  if (linktablelength) {
+    for (i = 0; i < LINKTABLESIZE; i++) linktable[i].source = 0;
+    linktablelength = 0;
+  }
+  linktablevalid = 0;
+#ifdef HASTIMER
+  after_timer.target = 0;
+  every_timer.target = 0;
+#endif
+#ifdef HASEVENTS
+  for (i = 0; i < EVENTLISTSIZE; i++) eventlist[i].target = 0;
+#endif
+}
+
+address_t linkhash(address_t a) {
+  return (a ^ (a >> 7)) & (LINKTABLESIZE - 1);
+}
+
+/* enter a link if the line exists, address 0 is never a NUMBER token */
+void addlink(address_t a, address_t l) {
+  address_t i, j;
+
+  i = lineindexsearch(l);
+  if (i >= lineindexlength || lineindex[i].l != l) return;
+  if (linktablelength >= LINKTABLESIZE / 4 * 3) return;
+
+  j = linkhash(a);
+  while (linktable[j].source && linktable[j].source != a) j = (j + 1) & (LINKTABLESIZE - 1);
+  if (!linktable[j].source) linktablelength++;
+  linktable[j].source = a;
+  linktable[j].target = lineindex[i].h + addrsize + 1;
+  linktable[j].line = l;
+}
+
+/* links are only used while running, interactively here is in the input buffer */
+linkentry* findlink(address_t a) {
+  address_t j;
+
+  if (st == SINT || !linktablevalid || linktabletop != top) return 0;
+  j = linkhash(a);
+  while (linktable[j].source) {
+    if (linktable[j].source == a) return &linktable[j];
+    j = (j + 1) & (LINKTABLESIZE - 1);
+  }
+  return 0;
+}
+
+address_t linktarget(address_t a) {
+  linkentry* e;
+
+  if ((e = findlink(a))) return e->target; else return 0;
+}
+
+/* walk the program once and link all constant targets, if not done already */
+void buildlinktable() {
+  address_t h = here;
+  address_t a, a0, l0;
+  token_t t;
+  mem_t on = 0;
+  mem_t ok;
+
+  if (linktablevalid && linktabletop == top) return;
+
+  clrlinktable();
+  if (!lineindexready()) {
+    here = h;
+    return;
+  }
+
+  here = 0;
+  while (here < top) {
+    gettoken();
+    t = token;
+again:
+    if (t == TON) on = 1;
+    else if (t == LINENUMBER || t == ':') on = 0;
+    else if (t == TGOTO || t == TGOSUB) {
+      a0 = here;
+      gettoken();
+      if (token != NUMBER) continue;
+      l0 = x;
+      gettoken();
+      if (!on) {
+        if (termsymbol()) addlink(a0, l0);
+        continue;
+      }
+
+      /* in ON lists, the first element is entered if all are constants */
+      ok = 1;
+      while (token == ',') {
+        a = here;
+        gettoken();
+        if (token != NUMBER) {
+          ok = 0;
+          break;
+        }
+        addlink(a, x);
+        gettoken();
+      }
+      if (ok && termsymbol()) addlink(a0, l0);
+      on = 0;
+    } else if (t == TTHEN || t == TELSE) {
+      a0 = here;
+      gettoken();
+      if (token == NUMBER) addlink(a0, x);
+
+      /* THEN GOTO and ELSE GOTO are linked like every other GOTO */
+      if (token == TGOTO || token == TGOSUB) {
+        t = token;
+        goto again;
+      }
+    }
+  }
+
+  linktabletop = top;
+  linktablevalid = 1;
+  here = h;
+}
+#else
+void clrlinktable() {}
+void buildlinktable() {}
+address_t linktarget(address_t a) {
+  return 0;
+}
+#endif
 
-/* find a line, look in cache then search from the beginning
+/* find a line, look in the index or the cache then search from the beginning
    x is used as the valid line number once a line is found
    hence x must be global
    (this is the logic of the gettoken mechanism)
@@ -3715,6 +5468,22 @@ address_t findinlinecache(address_t l) {
 void findline(address_t l) {
   address_t a;
 
+  /* the line index knows all lines */
+#if defined(LINEINDEXSIZE) && LINEINDEXSIZE>0
+  if (lineindexready()) {
+    a = lineindexsearch(l);
+    if (a < lineindexlength && lineindex[a].l == l) {
+      here = lineindex[a].h + addrsize + 1;
+      token = LINENUMBER;
+      ax = l;
+    } else {
+      here = top; /* like the search, error messages depend on this */
+      error(ELINE);
+    }
+    return;
+  }
+#endif
+
   /* we know it already, here to advance */
   if ((a = findinlinecache(l))) {
     here = a;
@@ -3736,6 +5505,16 @@ void findline(address_t l) {
   error(ELINE);
 }
 
+/* go to line l, h is its address if known from the link table */
+void findlinetarget(address_t l, address_t h) {
+  if (h) {
+    here = h;
+    token = LINENUMBER;
+    ax = l;
+  } else
+    findline(l);
+}
+
 /* finds the line of a location */
 address_t myline(address_t h) {
   address_t l = 0;
@@ -3814,10 +5593,227 @@ void diag() {
 }
 #endif
 
+/*
+   storeline keeps the line index in sync, the work is done in storeline2.
+   The line cache is cleared again as deleting a line calls findline().
+*/
 void storeline() {
+#if defined(LINEINDEXSIZE) && LINEINDEXSIZE>0
+  address_t l = ax;
+  address_t oldtop = top;
+  mem_t valid = lineindexvalid && lineindextop == top;
+#endif
+
+  /* the program grows into the string pool, move it away */
+#ifdef HASDYNAMICSTRINGS
+  parkstrings();
+#endif
+  storeline2();
+#ifdef HASDYNAMICSTRINGS
+  unparkstrings();
+#endif
+
+#if defined(LINEINDEXSIZE) && LINEINDEXSIZE>0
+  if (er || !valid) clrlineindex(); else updatelineindex(l, oldtop);
+#endif
+  clrlinecache();
+  clrlinktable();
+  clrbraketmap();
+  clrexprcache();
+}
+
+#ifdef HASCONSTFOLD
+/*
+   Constant folding. After a line is tokenized, pure constant parts of
+   expressions like 60*60 or (2+3) are evaluated once and stored as one
+   NUMBER token. Only + - * / MOD and brakets are folded, functions are
+   never called here, so RND, PEEK or MILLIS stay untouched. LIST shows
+   the folded line.
+
+   A value is only folded if it gives the same result with and without
+   forced integer mode and if it survives the conversion to text and
+   back, so that SAVE and LOAD reproduce the program. Negative results
+   are not folded because the lexer never produces negative numbers.
+   A number right after THEN, ELSE, GOTO and GOSUB or in an ON GOTO list 
+   is a line number and is never folded with what follows it.
+*/
+
+/* the operators binding stronger than + and - */
+mem_t foldterm(token_t t) {
+  return t == '*' || t == '/' || t == '%' || t == '^' || t == TSHL || t == TSHR;
+}
+
+/* the tokens after which a braket is only a braket */
+mem_t foldopen(token_t t) {
+  return foldterm(t) || t == '+' || t == '-' || t == '(' || t == ',' || t == '=' ||
+         t == '<' || t == '>' || t == NOTEQUAL || t == LESSEREQUAL || t == GREATEREQUAL ||
+         t == TAND || t == TOR || t == TNOT;
+}
+
+/* apply the operator o like term() and addexpression() do, 0 if we cannot fold */
+mem_t foldvalue(token_t o, number_t a, number_t b, number_t *r) {
+#ifdef HASFLOAT
+  number_t i;
+  char c[SBUFSIZE];
+
+  if (fabs(a) >= maxnum || fabs(b) >= maxnum) return 0;
+  switch (o) {
+    case '+':
+      *r = a + b;
+      i = trunc(a) + trunc(b);
+      break;
+    case '-':
+      *r = a - b;
+      i = trunc(a) - trunc(b);
+      break;
+    case '*':
+      *r = a * b;
+      i = trunc(a) * trunc(b);
+      break;
+    case '/':
+    case '%':
+      /* the int casts of term() are safe in this range on all platforms */
+      if (a >= 32768 || b >= 32768 || (int)b == 0) return 0;
+      if (o == '/') *r = a / b; else *r = (int)a % (int)b;
+      i = (o == '/') ? (int)a / (int)b : *r;
+      break;
+    default:
+      return 0;
+  }
+  if (!isfinite(*r) || *r < 0 || trunc(*r) != i) return 0;
+  c[writeshortest(c, *r)] = 0;
+  parsenumber2(c, &i);
+  return i == *r;
+#else
+  switch (o) {
+    case '+':
+      *r = a + b;
+      break;
+    case '-':
+      *r = a - b;
+      break;
+    case '*':
+      *r = a * b;
+      break;
+    case '/':
+      if (b == 0) return 0;
+      *r = a / b;
+      break;
+    case '%':
+      if (b == 0) return 0;
+      *r = a % b;
+      break;
+    default:
+      return 0;
+  }
+  return *r >= 0;
+#endif
+}
+
+/* replace the tokens from a to e by the number v */
+void foldstore(address_t a, address_t e, number_t v) {
+  memwrite2(a++, NUMBER);
+  setnumber(a, memwrite2, v);
+  a += numsize;
+  moveblock(e, top - e, a);
+  top -= e - a;
+}
+
+/*
+   fold the line starting at h and ending at top, a window of the
+   last six tokens is matched against the foldable patterns, after
+   every change the scan starts again, lines are short
+*/
+void foldline(address_t h) {
+  address_t a[6];
+  token_t t[6];
+  number_t v[6];
+  address_t here2 = here;
+  address_t ax2 = ax;
+  mem_t k, data, golist;
+
+restart:
+  for (k = 0; k < 6; k++) t[k] = ':';
+  data = 0;
+  golist = 0;
+  here = h;
+  do {
+    for (k = 0; k < 5; k++) {
+      a[k] = a[k + 1];
+      t[k] = t[k + 1];
+      v[k] = v[k + 1];
+    }
+    a[5] = here;
+    if (here < top) gettoken(); else token = EOL;
+    t[5] = token;
+    v[5] = x;
+
+    /* DATA records are read token by token, MAT needs its brakets, they stay as they are */
+    if (token == TDATA) data = 1;
+#ifdef HASMATRIX
+    if (token == TMAT) data = 1;
+#endif
+    if (token == ':') data = 0;
+    if (data) continue;
+
+    /* the line numbers of ON GOTO lists follow commas */
+    if (token == TGOTO || token == TGOSUB) golist = 1;
+    if (token == ':' || token == TELSE) golist = 0;
+
+    /* a number in brakets */
+    if (t[5] == ')' && t[4] == NUMBER && t[3] == '(' && foldopen(t[2])) {
+      foldstore(a[3], here, v[4]);
+      goto restart;
+    }
+
+    /* N1 op N2 followed by t[5], t[1] and t[0] are the tokens before N1 */
+    if (t[2] != NUMBER || t[4] != NUMBER) continue;
+
+    /* a line number must stay first, THEN 60+10 branches to 60 */
+    if (t[1] == TTHEN || t[1] == TELSE || t[1] == TGOTO || t[1] == TGOSUB || (golist && t[1] == ',')) continue;
+    if (t[3] == '*' || t[3] == '/' || t[3] == '%') {
+      if (foldterm(t[1]) || (t[1] == '-' && foldterm(t[0])) || t[5] == '^') continue;
+    } else if (t[3] == '+' || t[3] == '-') {
+      if (foldterm(t[1]) || t[1] == '+' || t[1] == '-' || foldterm(t[5])) continue;
+    } else continue;
+    if (foldvalue(t[3], v[2], v[4], &v[2])) {
+      foldstore(a[2], a[5], v[2]);
+      goto restart;
+    }
+  } while (token != EOL);
+
+  here = here2;
+  ax = ax2;
+}
+#endif
+
+/*
+   append the line in the input buffer to the end of the program,
+   the line number is in ax, here is the old top afterwards
+*/
+void appendline() {
+  address_t l = ax;
+
+  here = top;
+  token = LINENUMBER;
+  do {
+    storetoken();
+    if (er != 0 ) {
+      top = here;
+      here = 0;
+      return;
+    }
+    nexttoken();
+  } while (token != EOL);
+#ifdef HASCONSTFOLD
+  foldline(here + addrsize + 1);
+#endif
+  ax = l;
+}
+
+void storeline2() {
   const index_t lnlength = addrsize + 1;
   index_t linelength;
-  number_t newline;
   address_t here2, here3;
   address_t t1, t2;
   address_t y;
@@ -3840,21 +5836,8 @@ void storeline() {
    	stage 1: append the line at the end of the memory,
    	remember the line number on the stack and the old top in here
   */
-  t1 = ax;
-  here = top;
-  newline = here;
-  token = LINENUMBER;
-  do {
-    storetoken();
-    if (er != 0 ) {
-      top = newline;
-      here = 0;
-      return;
-    }
-    nexttoken();
-  } while (token != EOL);
-
-  ax = t1;									/* recall the line number */
+  appendline();
+  if (er != 0) return;
   linelength = top - here;	/* calculate the number of stored bytes */
 
   /*
@@ -4483,13 +6466,13 @@ char stringvalue(string_t* strp) {
         return 0;
       }
       nexttoken();
-      if (token != STRINGVAR) {
-        error(EARGS);
+      /* any string value, also a slice of a slice, nothing is copied */
+      if (!stringvalue(strp)) {
+        if (er == 0) error(EARGS);
         return 0;
       }
-      parsestringvar(strp, &lhs);
       if (er != 0) return 0;
-      k = strp->length; /* the length of the original string variable */
+      k = strp->length; /* the length of the original string */
       nexttoken();
       if (token != ',') {
         error(EARGS);
@@ -4559,7 +6542,9 @@ char stringvalue(string_t* strp) {
 
 void streval() {
   token_t t;
+#ifdef USEMEMINTERFACE
   address_t k;
+#endif
   string_t s1, s2;
   char* ir;
   address_t a;
@@ -4628,11 +6613,9 @@ void streval() {
 
   /* and a different character somewhere is also unequal */
 #ifdef USEMEMINTERFACE
-  if (s1.ir && s2.ir)
-    for (k = 0; k < s1.length; k++) {
-      if (s1.ir[k] != s2.ir[k]) goto neq;
-    }
-  else if (s1.address && s2.address)
+  if (s1.ir && s2.ir) {
+    if (s1.length > 0 && memcmp(s1.ir, s2.ir, s1.length)) goto neq;
+  } else if (s1.address && s2.address)
     for (k = 0; k < s1.length; k++) {
       if (memread2(s1.address + k) != memread2(s2.address + k)) goto neq;
     }
@@ -4649,7 +6632,7 @@ void streval() {
     }
   }
 #else
-  for (k = 0; k < s1.length; k++) if (s1.ir[k] != s2.ir[k]) goto neq;
+  if (s1.length > 0 && memcmp(s1.ir, s2.ir, s1.length)) goto neq;
 #endif
 
   /* which operator did we use */
@@ -4727,6 +6710,17 @@ void xbit() {
    evaluates constants, variables and all functions
 */
 
+#ifdef HASMULTIDIM
+/* pop three or more array indices, the first two go to i and j */
+void popindices(lhsobject_t* object) {
+  mem_t k;
+
+  for (k = args - 3; k >= 0; k--) object->k[k] = popaddress();
+  object->j = popaddress();
+  object->i = popaddress();
+}
+#endif
+
 /* helpers of factor - array access */
 void factorarray() {
   lhsobject_t object;
@@ -4751,11 +6745,23 @@ void factorarray() {
       object.i = popaddress();
       if (!USELONGJUMP && er) return;
       break;
-#endif
+    default:
+      if (args < 3 || args > MAXDIM) {
+        error(EARGS);
+        return;
+      }
+      popindices(&object);
+      if (!USELONGJUMP && er) return;
+      break;
+#else
     default:
       error(EARGS);
       return;
+#endif
   }
+#ifdef HASMULTIDIM
+  object.dims = args;
+#endif
   array(&object, 'g', &v);
   push(v);
 }
@@ -4792,8 +6798,11 @@ void factorlen() {
     case TCHR:
 #endif
     case TSTR:
-      error(EARGS);
-      return;
+      if (!stringvalue(&s)) return;
+      if (!USELONGJUMP && er) return;
+      push(s.length);
+      nexttoken();
+      break;
     default:
       expression();
       if (!USELONGJUMP && er) return;
@@ -4965,6 +6974,9 @@ void factorinstr() {
   char ch;
   address_t a;
   string_t s;
+#ifndef USEMEMINTERFACE
+  char* p;
+#endif
 
   nexttoken();
   if (token != '(') {
@@ -4990,6 +7002,15 @@ void factorinstr() {
   if (!USELONGJUMP && er) return;
 
   ch = pop();
+#ifndef USEMEMINTERFACE
+  /* strings in C memory are searched by the library */
+  if (s.ir) {
+    p = memchr(s.ir, ch, s.length);
+    if (p) a = p - s.ir + 1; else a = 0;
+    push(a);
+    goto done;
+  }
+#endif
   if (s.address) {
     for (a = 1; a <= s.length; a++) {
       if (memread2(s.address + a - 1) == ch) break;
@@ -5001,6 +7022,9 @@ void factorinstr() {
   }
   if (a > s.length) a = 0;
   push(a);
+#ifndef USEMEMINTERFACE
+done:
+#endif
   //nexttoken();
   if (token != ')') {
     error(EARGS);
@@ -5015,6 +7039,9 @@ void factorinstr() {
   address_t i = 1;
   string_t search;
   string_t s;
+#ifndef USEMEMINTERFACE
+  char* p;
+#endif
 
   nexttoken();
   if (token != '(') {
@@ -5060,51 +7087,46 @@ void factorinstr() {
     return;
   }
 
-  /* health check */
-  if (search.length == 0 || search.length + a > s.length || a == 0) {
+  /* health check, the search string has to fit behind the start */
+  if (search.length == 0 || a == 0 || search.length + a - 1 > s.length) {
     push(0);
     return;
   }
 
-  /* go through the search string */
-  while (i <= search.length) {
-
-    /* get one character from the string */
-    if (search.address) {
-      ch = memread2(search.address + i - 1);
-    } else {
-      ch = search.ir[i - 1];
-    }
-
-    /* search the character */
-    if (s.address) {
-      for (; a <= s.length; a++) {
-        if (memread2(s.address + a - 1) == ch) break;
-      }
-    } else {
-      for (; a <= s.length; a++) {
-        if ( s.ir[a - 1] == ch ) break;
-      }
-    }
-
-    /* we haven't found the character until the end of the string */
-    if (a > s.length) {
-      a = 0;
-      break;
-    }
-
-    /* next character */
-    i += 1;
-
+#ifndef USEMEMINTERFACE
+  /* strings in C memory, find the first character and compare the rest */
+  if (s.ir && search.ir) {
+    ch = search.ir[0];
+    while (a + search.length - 1 <= s.length) {
+      p = memchr(s.ir + a - 1, ch, s.length - search.length - a + 2);
+      if (!p) break;
+      a = p - s.ir + 1;
+      if (memcmp(p, search.ir, search.length) == 0) {
+        push(a);
+        return;
+      }
+      a++;
+    }
+    push(0);
+    return;
   }
+#endif
 
-  /* how did the search go? a rewind because we were at the end of the search part already */
-  if (i <= search.length) {
-    a = 0;
-  } else {
-    a = a - search.length + 1;
+  /* go through the string and compare the search string at every position */
+  for (; a + search.length - 1 <= s.length; a++) {
+    for (i = 0; i < search.length; i++) {
+      if (search.ir) ch = search.ir[i]; else ch = memread2(search.address + i);
+      if (s.ir) {
+        if (s.ir[a + i - 1] != ch) break;
+      } else {
+        if (memread2(s.address + a + i - 1) != ch) break;
+      }
+    }
+    if (i == search.length) break;
   }
 
+  /* we haven't found the string until the end */
+  if (a + search.length - 1 > s.length) a = 0;
 
   push(a);
 }
@@ -5145,6 +7167,21 @@ void factorasc() {
         push(0);
       nexttoken();
       break;
+#ifdef HASMSSTRINGS
+    case TRIGHT:
+    case TLEFT:
+    case TMID:
+    case TCHR:
+#endif
+    case TSTR:
+      if (!stringvalue(&s)) return;
+      if (!USELONGJUMP && er) return;
+      if (s.length > 0) {
+        if (s.ir) push(s.ir[0]); else push(memread2(s.address));
+      } else
+        push(0);
+      nexttoken();
+      break;
     default:
       error(EARGS);
       return;
@@ -5190,7 +7227,7 @@ void factor() {
       parsefunction(xrnd, 1);
       break;
     case TSIZE:
-      push(himem - top);
+      push(himem - FREERAM);
       break;
       /* Apple 1 BASIC functions */
 #ifdef HASAPPLE1
@@ -5346,6 +7383,13 @@ void factor() {
     case TASC:
       factorasc();
       break;
+#endif
+#ifdef HASMATRIX
+    case TSUM:
+    case TMIN:
+    case TMAX:
+      factormat();
+      break;
 #endif
     case TBIT:
       parsefunction(xbit, 2);
@@ -5611,6 +7655,9 @@ void andexpression() {
 /* expression function and boolean OR at the same time bitwise !*/
 void expression() {
   if (DEBUG) bdebug("exp\n");
+#if defined(EXPRCACHESIZE) && EXPRCACHESIZE>0 && defined(EXPRCODESIZE) && EXPRCODESIZE>0
+  if (st == SRUN && !debuglevel && exprcached()) return;
+#endif
   andexpression();
   if (!USELONGJUMP && er) return;
   if (token == TOR) {
@@ -5624,14 +7671,770 @@ void expression() {
 /* expression function simplified */
 void expression() {
   if (DEBUG) bdebug("exp\n");
+#if defined(EXPRCACHESIZE) && EXPRCACHESIZE>0 && defined(EXPRCODESIZE) && EXPRCODESIZE>0
+  if (st == SRUN && !debuglevel && exprcached()) return;
+#endif
   compexpression();
   if (!USELONGJUMP && er) return;
   if (token == TOR) {
     parseoperator(expression);
     if (!USELONGJUMP && er) return;
-    push((short)x | (short)y);
+    push((short)x | (short)y);
+  }
+}
+#endif
+
+/*
+   The expression cache. The first time an expression in the program 
+   is evaluated in RUN mode, it is compiled to postfix code. The code 
+   is stored in exprcode[], the table exprcache[] finds it by the 
+   location of the expression in the program. Later evaluations run the 
+   code on the stack and skip the token stream.
+
+   The compiler follows the recursive descent parser above rule by rule, 
+   the code does the same pushes, pops and function calls in the same 
+   order. x and y are set like parseoperator() does it and name holds the 
+   last variable read, so the state after an expression is the same. 
+   Only the integer fast path leaves x and y alone. 
+   Only numbers, variables, operators, brackets and the numerical functions 
+   called through parsefunction() are compiled. Everything else, like 
+   strings and arrays, is marked as not compilable and parsed each time.
+
+   The cache is cleared whenever the program changes. Run time settings
+   like booleanmode and forceint are evaluated when the code runs.
+*/
+#if defined(EXPRCACHESIZE) && EXPRCACHESIZE>0 && defined(EXPRCODESIZE) && EXPRCODESIZE>0
+#if (EXPRCACHESIZE & (EXPRCACHESIZE - 1)) != 0
+#error "EXPRCACHESIZE must be a power of two"
+#endif
+
+/* the postfix instructions */
+#define EXEND 0
+#define EXNUM 1
+#define EXVAR 2
+#define EXCALL 3
+#define EXZERO 4
+#define EXNEG 5
+#define EXNOT 6
+#define EXADD 7
+#define EXSUB 8
+#define EXMUL 9
+#define EXDIV 10
+#define EXMOD 11
+#define EXSHL 12
+#define EXSHR 13
+#define EXPOW 14
+#define EXEQ 15
+#define EXNE 16
+#define EXGT 17
+#define EXLT 18
+#define EXLE 19
+#define EXGE 20
+#define EXAND 21
+#define EXOR 22
+#define EXINT 23
+
+/* here is after the first token, end is the token after the expression, code 0 means not compilable */
+typedef struct {
+  address_t here;
+  address_t end;
+  address_t code;
+  index_t depth;
+} exprentry;
+exprentry exprcache[EXPRCACHESIZE];
+unsigned char exprcode[EXPRCODESIZE];
+address_t exprcodetop = 1;
+address_t exprcachelength = 0;
+address_t exprcachetop = 0;
+
+/* the compiler state, the start of the current token, the code being written and the stack depth */
+address_t exprstart;
+address_t exprout;
+index_t exprdepth;
+index_t exprmaxdepth;
+
+/* the functions the compiler knows, the same as in factor() */
+typedef struct {
+  token_t t;
+  void (*f)();
+  mem_t n;
+} exprfunction;
+const exprfunction exprfunctions[] = {
+  {TABS, xabs, 1}, {TRND, xrnd, 1}, {TINT, xint, 1}, {TBIT, xbit, 2},
+#ifdef HASAPPLE1
+  {TSGN, xsgn, 1}, {TPEEK, xpeek, 1},
+#endif
+#ifdef HASSTEFANSEXT
+  {TSQR, sqr, 1}, {TMAP, xmap, 5}, {TPOW, xpow, 2},
+#endif
+#ifdef HASARDUINOIO
+  {TMILLIS, bmillis, 1},
+#endif
+#ifdef HASFLOAT
+  {TSIN, xsin, 1}, {TCOS, xcos, 1}, {TTAN, xtan, 1},
+  {TATAN, xatan, 1}, {TLOG, xlog, 1}, {TEXP, xexp, 1},
+#endif
+  {0, 0, 0}
+};
+
+void clrexprcache() {
+  address_t i;
+
+  if (exprcachelength) {
+    for (i = 0; i < EXPRCACHESIZE; i++) exprcache[i].here = 0;
+    exprcachelength = 0;
+  }
+  exprcodetop = 1;
+  exprcachetop = top;
+}
+
+/* the slot of an expression or the empty slot for it */
+address_t exprslot(address_t h) {
+  address_t i;
+
+  if (exprcachetop != top) clrexprcache();
+  i = (h ^ (h >> 7)) & (EXPRCACHESIZE - 1);
+  while (exprcache[i].here && exprcache[i].here != h) i = (i + 1) & (EXPRCACHESIZE - 1);
+  return i;
+}
+
+/* write to the code buffer, the compiler gives up if it is full */
+mem_t exprput(void* p, address_t l) {
+  if (exprout + l >= EXPRCODESIZE) return 0;
+  memcpy(&exprcode[exprout], p, l);
+  exprout += l;
+  return 1;
+}
+
+mem_t exprop(unsigned char c) {
+  if (c == EXNUM || c == EXINT || c == EXVAR || c == EXZERO) {
+    if (++exprdepth > exprmaxdepth) exprmaxdepth = exprdepth;
+  } else if (c >= EXADD) exprdepth--;
+  return exprput(&c, 1);
+}
+
+void exprnext() {
+  exprstart = here;
+  nexttoken();
+}
+
+/* the compiler, one function for each function of the parser */
+/* like parseoperator(), a unary minus negates the right operand */
+mem_t cparseoperator(mem_t (*f)()) {
+  mem_t u = 0;
+
+  exprnext();
+  if (token == '-') {
+    u = 1;
+    exprnext();
+  }
+  if (!f()) return 0;
+  return u ? exprop(EXNEG) : 1;
+}
+
+mem_t cfactor() {
+  address_t a;
+  mem_t i, n;
+#ifdef HASINTEGERPATH
+  exint_t l;
+#endif
+
+  switch (token) {
+    case NUMBER:
+#ifdef HASINTEGERPATH
+      if (x <= maxnum && x >= -maxnum && (l = (exint_t)x) == x)
+        return exprop(EXINT) && exprput(&l, sizeof(exint_t));
+#endif
+      return exprop(EXNUM) && exprput(&x, sizeof(number_t));
+    case VARIABLE:
+#ifdef HASLONGNAMES
+      a = here - name.l - 1;
+#else
+      a = here - 2;
+#endif
+      return exprop(EXVAR) && exprput(&a, sizeof(address_t));
+    case '(':
+      exprnext();
+      if (!cexpression()) return 0;
+      return token == ')';
+    default:
+      for (i = 0; exprfunctions[i].t != 0; i++) if (exprfunctions[i].t == token) break;
+      if (exprfunctions[i].t == 0) return 0;
+
+      /* like parsesubscripts(), exactly n arguments in brackets */
+      exprnext();
+      if (token != '(') return 0;
+      exprnext();
+      n = 0;
+      if (!termsymbol()) {
+        do {
+          if (!cexpression()) return 0;
+          n++;
+          if (token == ',') exprnext(); else break;
+        } while (1);
+      }
+      if (token != ')' || n != exprfunctions[i].n) return 0;
+      exprdepth -= n - 1;
+      if (exprdepth > exprmaxdepth) exprmaxdepth = exprdepth;
+      return exprop(EXCALL) && exprput(&i, 1);
+  }
+}
+
+#ifdef HASPOWER
+#ifdef POWERRIGHTTOLEFT
+mem_t cpower() {
+  if (!cfactor()) return 0;
+  exprnext();
+  if (token == '^') return cparseoperator(cpower) && exprop(EXPOW);
+  return 1;
+}
+#else
+mem_t cpower() {
+  if (!cfactor()) return 0;
+  while (1) {
+    exprnext();
+    if (token != '^') return 1;
+    if (!cparseoperator(cfactor) || !exprop(EXPOW)) return 0;
+  }
+}
+#endif
+
+mem_t cterm() {
+  unsigned char op;
+
+  if (!cpower()) return 0;
+  while (1) {
+    switch (token) {
+      case '*': op = EXMUL; break;
+      case '/': op = EXDIV; break;
+      case '%': op = EXMOD; break;
+      case TSHL: op = EXSHL; break;
+      case TSHR: op = EXSHR; break;
+      default: return 1;
+    }
+    if (!cparseoperator(cpower) || !exprop(op)) return 0;
+  }
+}
+#else
+mem_t cterm() {
+  unsigned char op;
+
+  if (!cfactor()) return 0;
+  while (1) {
+    exprnext();
+    switch (token) {
+      case '*': op = EXMUL; break;
+      case '/': op = EXDIV; break;
+      case '%': op = EXMOD; break;
+      case TSHL: op = EXSHL; break;
+      case TSHR: op = EXSHR; break;
+      default: return 1;
+    }
+    if (!cparseoperator(cfactor) || !exprop(op)) return 0;
+  }
+}
+#endif
+
+mem_t caddexpression() {
+  if (token != '+' && token != '-') {
+    if (!cterm()) return 0;
+  } else {
+    if (!exprop(EXZERO)) return 0;
+  }
+  while (token == '+' || token == '-') {
+    if (token == '+') {
+      if (!cparseoperator(cterm) || !exprop(EXADD)) return 0;
+    } else {
+      if (!cparseoperator(cterm) || !exprop(EXSUB)) return 0;
+    }
+  }
+  return 1;
+}
+
+mem_t ccompexpression() {
+  unsigned char op;
+
+  if (!caddexpression()) return 0;
+  switch (token) {
+    case '=': op = EXEQ; break;
+    case NOTEQUAL: op = EXNE; break;
+    case '>': op = EXGT; break;
+    case '<': op = EXLT; break;
+    case LESSEREQUAL: op = EXLE; break;
+    case GREATEREQUAL: op = EXGE; break;
+    default: return 1;
+  }
+  return cparseoperator(ccompexpression) && exprop(op);
+}
+
+#ifdef HASAPPLE1
+mem_t cnotexpression() {
+  if (token == TNOT) {
+    exprnext();
+    return cexpression() && exprop(EXNOT);
+  }
+  return ccompexpression();
+}
+
+mem_t candexpression() {
+  if (!cnotexpression()) return 0;
+  if (token == TAND) return cparseoperator(cexpression) && exprop(EXAND);
+  return 1;
+}
+
+mem_t cexpression() {
+  if (!candexpression()) return 0;
+  if (token == TOR) return cparseoperator(cexpression) && exprop(EXOR);
+  return 1;
+}
+#else
+mem_t cexpression() {
+  if (!ccompexpression()) return 0;
+  if (token == TOR) return cparseoperator(cexpression) && exprop(EXOR);
+  return 1;
+}
+#endif
+
+/* compile the expression at here into the slot i, restores the token stream */
+void exprcompile(address_t i) {
+  address_t h = here;
+  token_t t = token;
+  number_t xs = x;
+  name_t n = name;
+  string_t s = sr;
+
+  exprout = exprcodetop;
+  exprdepth = 0;
+  exprmaxdepth = 0;
+  exprcache[i].here = h;
+  exprcache[i].code = 0;
+  if (cexpression() && exprop(EXEND)) {
+    exprcache[i].code = exprcodetop;
+    exprcache[i].end = exprstart;
+    exprcache[i].depth = exprmaxdepth;
+    exprcodetop = exprout;
+  }
+  exprcachelength++;
+
+  here = h;
+  token = t;
+  x = xs;
+  name = n;
+  sr = s;
+}
+
+/* the number_t operators of the code, the operands are in x and y */
+number_t exprnumber(unsigned char op) {
+  switch (op) {
+    case EXADD:
+      return x + y;
+    case EXSUB:
+      return x - y;
+    case EXMUL:
+      return x * y;
+    case EXDIV:
+      if (y == 0) break;
+#ifndef HASFLOAT
+      return x / y;
+#else
+      if (forceint) return (int)x / (int)y; else return x / y;
+#endif
+    case EXMOD:
+      if (y == 0) break;
+#ifndef HASFLOAT
+      return x % y;
+#else
+      return (int)x % (int)y;
+#endif
+    case EXSHL:
+      return (int)x << (int)y;
+    case EXSHR:
+      return (int)x >> (int)y;
+#ifdef HASPOWER
+    case EXPOW:
+      return bpow(x, y);
+#endif
+    case EXEQ:
+#ifndef HASFLOAT
+      return x == y ? booleanmode : 0;
+#else
+      return fabs(x - y) <= epsilon ? booleanmode : 0;
+#endif
+    case EXNE:
+#ifndef HASFLOAT
+      return x != y ? booleanmode : 0;
+#else
+      return fabs(x - y) > epsilon ? booleanmode : 0;
+#endif
+    case EXGT:
+      return x > y ? booleanmode : 0;
+    case EXLT:
+      return x < y ? booleanmode : 0;
+    case EXLE:
+      return x <= y ? booleanmode : 0;
+    case EXGE:
+      return x >= y ? booleanmode : 0;
+    case EXAND:
+      return (short)x & (short)y;
+    case EXOR:
+      return (short)x | (short)y;
+  }
+  error(EDIVIDE);
+  return 0;
+}
+
+#ifdef HASINTEGERPATH
+/*
+   The integer fast path of float builds. An integer is kept in the l
+   member of a stack entry, bit d of tags is set if the entry d above
+   the base b of the expression holds one. Integer results are exact,
+   they stay integers only as long as a number_t holds them exactly,
+   hence the results are the same as with number_t arithmetic. Function
+   arguments and the result of the expression are converted back.
+*/
+#define EXBIT(s) ((s) - b < 8 * sizeof(unsigned long) ? 1UL << ((s) - b) : 0)
+#define EXISINT(s) (tags & EXBIT(s))
+#define EXTONUMBER(s) if (EXISINT(s)) { stack[s].n = stack[s].l; tags &= ~EXBIT(s); }
+#define EXINRANGE(v) ((v) <= intmax && (v) >= -intmax)
+
+/* the integer operators, 0 if the result is no exact integer */
+mem_t exprinteger(unsigned char op, exint_t *l, exint_t r) {
+  switch (op) {
+    case EXADD:
+      *l += r;
+      return 1;
+    case EXSUB:
+      *l -= r;
+      return 1;
+    case EXMUL:
+      if (*l >= 32768 || *l <= -32768 || r >= 32768 || r <= -32768) return 0;
+      *l *= r;
+      return 1;
+    case EXDIV:
+      if (r == 0) return 0;
+      if (forceint) *l = (int)*l / (int)r;
+      else if (*l % r == 0) *l /= r;
+      else return 0;
+      return 1;
+    case EXMOD:
+      if (r == 0) return 0;
+      *l = (int)*l % (int)r;
+      return 1;
+    case EXSHL:
+      *l = (int)*l << (int)r;
+      return 1;
+    case EXSHR:
+      *l = (int)*l >> (int)r;
+      return 1;
+    case EXEQ:
+      *l = fabs((number_t)(*l - r)) <= epsilon ? booleanmode : 0;
+      return 1;
+    case EXNE:
+      *l = fabs((number_t)(*l - r)) > epsilon ? booleanmode : 0;
+      return 1;
+    case EXGT:
+      *l = *l > r ? booleanmode : 0;
+      return 1;
+    case EXLT:
+      *l = *l < r ? booleanmode : 0;
+      return 1;
+    case EXLE:
+      *l = *l <= r ? booleanmode : 0;
+      return 1;
+    case EXGE:
+      *l = *l >= r ? booleanmode : 0;
+      return 1;
+    case EXAND:
+      *l = (short)*l & (short)r;
+      return 1;
+    case EXOR:
+      *l = (short)*l | (short)r;
+      return 1;
+  }
+  return 0;
+}
+#endif
+
+#ifndef HASSTACKREGISTER
+/* run the code of an expression on the stack */
+#ifdef HASINTEGERPATH
+#define EXPUSHINT(v) if (EXINRANGE(v) && (m = EXBIT(sp)) && sp < STACKSIZE) \
+  { stack[sp++].l = (v); tags |= m; } else push((number_t)(v))
+#endif
+
+void exprrun(unsigned char* c, index_t depth) {
+  address_t a;
+  mem_t i;
+  unsigned char op;
+#ifdef HASINTEGERPATH
+  address_t b = sp;
+  unsigned long tags = 0, m;
+  exint_t l, r;
+  number_t v;
+#endif
+
+  while (1) {
+    switch (op = *c++) {
+      case EXEND:
+#ifdef HASINTEGERPATH
+        if (sp > b) EXTONUMBER(sp - 1);
+#endif
+        return;
+      case EXNUM:
+        memcpy(&x, c, sizeof(number_t));
+        c += sizeof(number_t);
+        push(x);
+        break;
+#ifdef HASINTEGERPATH
+      case EXINT:
+        memcpy(&l, c, sizeof(exint_t));
+        c += sizeof(exint_t);
+        EXPUSHINT(l);
+        break;
+#endif
+      case EXVAR:
+        memcpy(&a, c, sizeof(address_t));
+        c += sizeof(address_t);
+#ifdef HASDIRECTMEM
+        memgetname(a, &name);
+#else
+        getname(a, &name, memread);
+#endif
+        name.token = VARIABLE;
+#ifdef HASINTEGERPATH
+        v = getvar(&name);
+        if (EXINRANGE(v) && (l = (exint_t)v) == v) {
+          EXPUSHINT(l);
+        } else push(v);
+#else
+        push(getvar(&name));
+#endif
+        break;
+      case EXCALL:
+        i = *c++;
+        args = exprfunctions[i].n;
+#ifdef HASINTEGERPATH
+        for (a = sp - args; a < sp; a++) EXTONUMBER(a);
+#endif
+        exprfunctions[i].f();
+        break;
+      case EXZERO:
+#ifdef HASINTEGERPATH
+        EXPUSHINT(0);
+#else
+        push(0);
+#endif
+        break;
+      case EXNEG:
+#ifdef HASINTEGERPATH
+        if (EXISINT(sp - 1)) {
+          stack[sp - 1].l = -stack[sp - 1].l;
+          break;
+        }
+#endif
+        push(-pop());
+        break;
+      case EXNOT:
+#ifdef HASINTEGERPATH
+        if (EXISINT(sp - 1)) {
+          l = stack[sp - 1].l;
+          if (booleanmode == -1) stack[sp - 1].l = ~(short)l;
+          else stack[sp - 1].l = (l == 0);
+          break;
+        }
+#endif
+        if (booleanmode == -1) push(~(short)pop());
+        else if (pop() == 0) push(1); else push(0);
+        break;
+      default:
+#ifdef HASINTEGERPATH
+        if (EXISINT(sp - 1) && EXISINT(sp - 2)) {
+          r = stack[--sp].l;
+          l = stack[--sp].l;
+          tags &= ~(EXBIT(sp) | EXBIT(sp + 1));
+          if (exprinteger(op, &l, r)) {
+            EXPUSHINT(l);
+            break;
+          }
+          x = l;
+          y = r;
+        } else {
+          EXTONUMBER(sp - 1);
+          EXTONUMBER(sp - 2);
+          y = pop();
+          x = pop();
+        }
+#else
+        y = pop();
+        x = pop();
+#endif
+        push(exprnumber(op));
+    }
+    if (!USELONGJUMP && er) return;
+  }
+}
+#else
+/*
+   The stack register version. The top of the stack is kept in the 
+   local t, the entries below it are in stack[b+1] to stack[s-1], 
+   stack[b] only receives the first spill of t. The compiler knows the 
+   depth of the code, it is checked once at the start, and sp is only 
+   updated for function calls. With the integer path, bit s of tags 
+   belongs to t.
+*/
+#ifdef HASFLOAT
+#define EXTRUNC(v) (forceint ? trunc(v) : (v))
+#else
+#define EXTRUNC(v) (v)
+#endif
+#define EXPUSH(v) { stack[s++] = t; t.n = EXTRUNC(v); }
+#ifdef HASINTEGERPATH
+#define EXPUSHINT(v) { stack[s++] = t; if (EXINRANGE(v) && (m = EXBIT(s))) { t.l = (v); tags |= m; } else t.n = (v); }
+#endif
+
+void exprrun(unsigned char* c, index_t depth) {
+  address_t a;
+  address_t s = sp;
+  accu_t t;
+  mem_t i;
+  unsigned char op;
+#ifdef HASINTEGERPATH
+  address_t b = sp;
+  unsigned long tags = 0, m;
+  exint_t l;
+  number_t v;
+#endif
+
+  if (sp + depth >= STACKSIZE) {
+    error(ESTACK);
+    return;
+  }
+  t.n = 0;
+
+  while (1) {
+    switch (op = *c++) {
+      case EXEND:
+#ifdef HASINTEGERPATH
+        if (EXISINT(s)) t.n = t.l;
+#endif
+        stack[s - 1] = t;
+        sp = s;
+        return;
+      case EXNUM:
+        memcpy(&x, c, sizeof(number_t));
+        c += sizeof(number_t);
+        EXPUSH(x);
+        break;
+#ifdef HASINTEGERPATH
+      case EXINT:
+        memcpy(&l, c, sizeof(exint_t));
+        c += sizeof(exint_t);
+        EXPUSHINT(l);
+        break;
+#endif
+      case EXVAR:
+        memcpy(&a, c, sizeof(address_t));
+        c += sizeof(address_t);
+#ifdef HASDIRECTMEM
+        memgetname(a, &name);
+#else
+        getname(a, &name, memread);
+#endif
+        name.token = VARIABLE;
+#ifdef HASINTEGERPATH
+        v = getvar(&name);
+        if (EXINRANGE(v) && (l = (exint_t)v) == v) EXPUSHINT(l)
+        else EXPUSH(v)
+#else
+        EXPUSH(getvar(&name));
+#endif
+        break;
+      case EXCALL:
+        i = *c++;
+        args = exprfunctions[i].n;
+#ifdef HASINTEGERPATH
+        if (EXISINT(s)) t.n = t.l;
+        for (a = s - args + 1; a < s; a++) EXTONUMBER(a);
+        tags &= ~EXBIT(s);
+#endif
+        stack[s] = t;
+        sp = s + 1;
+        exprfunctions[i].f();
+        s = sp - 1;
+        t = stack[s];
+        break;
+      case EXZERO:
+#ifdef HASINTEGERPATH
+        EXPUSHINT(0);
+#else
+        EXPUSH(0);
+#endif
+        break;
+      case EXNEG:
+#ifdef HASINTEGERPATH
+        if (EXISINT(s)) {
+          t.l = -t.l;
+          break;
+        }
+#endif
+        t.n = -t.n;
+        break;
+      case EXNOT:
+#ifdef HASINTEGERPATH
+        if (EXISINT(s)) t.n = t.l;
+        tags &= ~EXBIT(s);
+#endif
+        if (booleanmode == -1) t.n = ~(short)t.n;
+        else t.n = (t.n == 0);
+        break;
+      default:
+        s--;
+#ifdef HASINTEGERPATH
+        if (EXISINT(s) && EXISINT(s + 1)) {
+          l = stack[s].l;
+          tags &= ~EXBIT(s + 1);
+          if (exprinteger(op, &l, t.l) && EXINRANGE(l)) {
+            t.l = l;
+            break;
+          }
+          x = stack[s].l;
+          y = t.l;
+          tags &= ~EXBIT(s);
+        } else {
+          x = EXISINT(s) ? stack[s].l : stack[s].n;
+          y = EXISINT(s + 1) ? t.l : t.n;
+          tags &= ~(EXBIT(s) | EXBIT(s + 1));
+        }
+#else
+        x = stack[s].n;
+        y = t.n;
+#endif
+        t.n = EXTRUNC(exprnumber(op));
+    }
+    if (!USELONGJUMP && er) return;
+  }
+}
+#endif
+
+/* evaluate an expression from the cache, 0 if it has to be parsed */
+mem_t exprcached() {
+  address_t i;
+
+  i = exprslot(here);
+  if (!exprcache[i].here) {
+    if (exprcachelength >= EXPRCACHESIZE / 4 * 3) return 0;
+    exprcompile(i);
   }
+  if (!exprcache[i].code) return 0;
+
+  fastticker();
+  exprrun(exprcode + exprcache[i].code, exprcache[i].depth);
+  here = exprcache[i].end;
+  nexttoken();
+  return 1;
 }
+#else
+void clrexprcache() {}
 #endif
 
 /*
@@ -5795,9 +8598,19 @@ void lefthandside(lhsobject_t* lhs) {
           if (!USELONGJUMP && er) return;
           break;
         default:
+#ifdef HASMULTIDIM
+          if (args >= 3 && args <= MAXDIM) {
+            popindices(lhs);
+            if (!USELONGJUMP && er) return;
+            break;
+          }
+#endif
           error(EARGS);
           return;
       }
+#ifdef HASMULTIDIM
+      lhs->dims = args;
+#endif
       nexttoken();
       break;
 #ifdef HASAPPLE1
@@ -5839,7 +8652,11 @@ void assignnumber2(lhsobject_t* lhs, number_t x) {
 #ifdef HASAPPLE1
     case STRINGVAR:
 
-      /* find the string variable */
+      /* find the string variable, dynamic strings need room for the character */
+#ifdef HASDYNAMICSTRINGS
+      reservestring(&lhs->name, lhs->j, lhs->i, 0);
+      if (!USELONGJUMP && er) return;
+#endif
       getstring(&sr, &lhs->name, lhs->i, lhs->j);
       if (!USELONGJUMP && er) return;
 
@@ -5921,6 +8738,12 @@ nextstring:
 
       /* we now process the source string */
 
+      /* dynamic strings first make room for the bytes, this can move sr */
+#ifdef HASDYNAMICSTRINGS
+      reservestring(&lhs.name, lhs.j, lhs.i2 ? lhs.i2 : lhs.i + sr.length - 1, &sr);
+      if (!USELONGJUMP && er) return;
+#endif
+
       /* getstring of the destination */
       getstring(&sl, &lhs.name, lhs.i, lhs.j);
       if (!USELONGJUMP && er) return;
@@ -5999,6 +8822,13 @@ addstring:
 void assignstring(string_t* sl, string_t* sr, stringlength_t copybytes) {
   stringlength_t k;
 
+  /* a string copied onto itself, typically the A$ in A$=A$+X$, stays as it is */
+#ifdef USEMEMINTERFACE
+  if (sl->address && !sr->ir && sr->address == sl->address) return;
+#else
+  if (sl->ir && sr->ir == sl->ir) return;
+#endif
+
   /* if we have a memory model that needs the mem interface, go through the addresses by default
   	else use just the pointers */
 
@@ -6067,6 +8897,9 @@ void xinput() {
   address_t maxlen, newlength; /* the maximum length of the string to be read */
   int k = 0; /* the result of the number conversion */
   string_t s;
+#ifdef HASDYNAMICSTRINGS
+  char tmpchar; /* the byte ins() overwrites in front of the string */
+#endif
   char* buffer; /* the buffer we use for input */
   address_t bufsize; /* the size of the buffer */
 
@@ -6182,6 +9015,12 @@ again:
         break;
 #ifdef HASAPPLE1
       case STRINGVAR:
+        /* dynamic strings get room for a line of input, unused bytes are given back later */
+#ifdef HASDYNAMICSTRINGS
+        reservestring(&lhs.name, lhs.j, lhs.i2 ? lhs.i2 : lhs.i + BUFSIZE - 3, 0);
+        if (!USELONGJUMP && er) return;
+#endif
+
         /* the destination address of the lefthandside, on the fly create included */
         getstring(&s, &lhs.name, lhs.i, lhs.j);
         if (!USELONGJUMP && er) return;
@@ -6208,7 +9047,14 @@ again:
         /* now read the string inplace */
         if (prompt) showprompt();
 #ifndef USEMEMINTERFACE
+#ifndef HASDYNAMICSTRINGS
         newlength = ins(s.ir - 1, maxlen);
+#else
+        /* ins() puts the length in front of the string, this is the chunk header here */
+        tmpchar = s.ir[-1];
+        newlength = ins(s.ir - 1, maxlen);
+        s.ir[-1] = tmpchar;
+#endif
 #else
         newlength = ins(spistrbuf1, maxlen);
 
@@ -6229,6 +9075,9 @@ again:
         /* classical Apple 1 behaviour is string truncation in substring logic */
         newlength = lhs.i + newlength - 1;
         setstringlength(&lhs.name, newlength, lhs.j);
+#ifdef HASDYNAMICSTRINGS
+        trimstring(&lhs.name, lhs.j);
+#endif
         break;
 #endif
     }
@@ -6258,6 +9107,19 @@ resetinput:
 void xgoto() {
   token_t t = token;
   number_t x;
+#ifdef HASLINKTABLE
+  linkentry* e;
+
+  /* a linked constant target, skip the number and branch */
+  if ((e = findlink(here))) {
+    here += numsize + 1;
+    nexttoken();
+    if (t == TGOSUB) pushgosubstack(0);
+    if (!USELONGJUMP && er) return;
+    findlinetarget(e->line, e->target);
+    return;
+  }
+#endif
 
   if (!expectexpr()) return;
   if (t == TGOSUB) pushgosubstack(0);
@@ -6306,6 +9168,7 @@ void xreturn() {
 */
 void xif() {
   mem_t nl = 0;
+  address_t a;
 
   if (!expectexpr()) return;
   x = pop();
@@ -6355,9 +9218,10 @@ processelse:
 
     /* now process ELSE */
     if (token == TELSE) {
+      a = here;
       nexttoken();
       if (token == NUMBER) {
-        findline((address_t) x);
+        findlinetarget((address_t) x, linktarget(a));
         return;
       }
     }
@@ -6368,9 +9232,10 @@ processelse:
 #ifdef HASAPPLE1
   /* then can be on a new line */
   if (token == TTHEN) {
+    a = here;
     nexttoken();
     if (token == NUMBER) {
-      findline((address_t) x);
+      findlinetarget((address_t) x, linktarget(a));
     }
   }
 #endif
@@ -6422,9 +9287,66 @@ void xelse() {
   	DO DEND
     SWITCH SWEND
 
+
+   The scan is remembered in the braket map. It maps the location where
+   a scan started and the opening symbol to the location after the closing
+   symbol. Once a loop has been skipped, it is skipped in one step. The 
+   map is valid until the program changes. Interactively nothing is 
+   remembered as the input buffer changes.
 */
+#if defined(BRAKETMAPSIZE) && BRAKETMAPSIZE>0
+#if (BRAKETMAPSIZE & (BRAKETMAPSIZE - 1)) != 0
+#error "BRAKETMAPSIZE must be a power of two"
+#endif
+typedef struct {
+  address_t start;
+  address_t end;
+  token_t bra;
+} braketentry;
+braketentry braketmap[BRAKETMAPSIZE];
+address_t braketmaplength = 0;
+address_t braketmaptop = 0;
+
+void clrbraketmap() {
+  address_t i;
+
+  if (braketmaplength) {
+    for (i = 0; i < BRAKETMAPSIZE; i++) braketmap[i].start = 0;
+    braketmaplength = 0;
+  }
+  braketmaptop = top;
+}
+
+/* the slot of a scan or the empty slot for it, start is never 0 */
+address_t braketslot(address_t a, token_t bra) {
+  address_t i;
+
+  if (braketmaptop != top) clrbraketmap();
+  i = (a ^ (a >> 7) ^ ((address_t) bra * 31)) & (BRAKETMAPSIZE - 1);
+  while (braketmap[i].start && (braketmap[i].start != a || braketmap[i].bra != bra))
+    i = (i + 1) & (BRAKETMAPSIZE - 1);
+  return i;
+}
+#else
+void clrbraketmap() {}
+#endif
+
 void findbraket(token_t bra, token_t ket) {
   address_t fnc = 0;
+#if defined(BRAKETMAPSIZE) && BRAKETMAPSIZE>0
+  address_t a = here;
+  address_t i;
+
+  /* the scan was done before */
+  if (st != SINT) {
+    i = braketslot(a, bra);
+    if (braketmap[i].start) {
+      here = braketmap[i].end;
+      token = ket;
+      return;
+    }
+  }
+#endif
 
   while (1) {
 
@@ -6436,7 +9358,19 @@ void findbraket(token_t bra, token_t ket) {
     }
 
     if (token == ket) {
-      if (fnc == 0) return; else fnc--;
+      if (fnc == 0) {
+#if defined(BRAKETMAPSIZE) && BRAKETMAPSIZE>0
+        /* remember the scan, keeping the map at most three quarters full */
+        if (st != SINT && braketmaplength < BRAKETMAPSIZE / 4 * 3) {
+          i = braketslot(a, bra);
+          braketmap[i].start = a;
+          braketmap[i].end = here;
+          braketmap[i].bra = bra;
+          braketmaplength++;
+        }
+#endif
+        return;
+      } else fnc--;
     }
 
     if (token == bra) fnc++;
@@ -6716,7 +9650,11 @@ void outputtoken() {
 
   switch (token) {
     case NUMBER:
+#ifdef HASFLOAT
+      outs(sbuffer, writeshortest(sbuffer, x));
+#else
       outnumber(x);
+#endif
       break;
     case LINENUMBER:
       outnumber(ax);
@@ -7019,10 +9957,14 @@ void xrun() {
 
     /* all reset on run */
     clrvars();
+#if defined(HASAPPLE1) && defined(HEAPCACHESIZE) && HEAPCACHESIZE > 0
+    heapcachehits = heapcachemisses = 0;
+#endif
     clrgosubstack();
     clrforstack();
     clrdata();
     clrlinecache();
+    buildlinktable();
     ert = 0;
     ioer = 0;
     fncontext = 0;
@@ -7117,6 +10059,10 @@ void resetbasicstate() {
   clrdata();
   clrvars();
   clrlinecache();
+  clrlineindex();
+  clrlinktable();
+  clrbraketmap();
+  clrexprcache();
 
   /* error status reset */
   reseterror();
@@ -7154,6 +10100,15 @@ void xnew() {
   himem = memsize;
   zeroblock(0, memsize);
   top = 0;
+#ifdef HASDYNAMICSTRINGS
+  strpool = strpooltop = 0;
+  strparked = 0;
+#endif
+#ifdef HASAPPLE1
+  clrheapcache();
+  clrarraycache();
+  clrheapindex();
+#endif
 
   if (DEBUG) outsc("** clearing EEPROM state \n ");
   /* on EEPROM systems also clear the stored state and top */
@@ -7249,6 +10204,12 @@ void xclr() {
 
     /* we have to clear an object, call free */
     ax = bfree(&variable);
+#ifdef HASCOMPACTARRAYS
+    if (ax == 0 && variable.token == ARRAYVAR && findcompact(&variable)) {
+      variable.token = bfind_object.name.token;
+      ax = bfree(&variable);
+    }
+#endif
     if (ax == 0) {
       if (variable.token != TBUFFER) {
         error(EVARIABLE);
@@ -7279,15 +10240,39 @@ void xdim() {
   name_t variable;
   address_t x;
   address_t y = 1;
+#ifdef HASMULTIDIM
+  address_t d[MAXDIM];
+  mem_t k;
+#endif
+#ifdef HASCOMPACTARRAYS
+  token_t type = ARRAYVAR;
+#endif
 
   /* which object should be dimensioned or created */
   nexttoken();
 
+  /* compact arrays, the type applies to all arrays of the statement */
+#ifdef HASCOMPACTARRAYS
+  if (token == TBYTE || token == TINT || token == TLONG) {
+    type = token;
+    nexttoken();
+  }
+#endif
+
 nextvariable:
   if (token == ARRAYVAR || token == STRINGVAR ) {
 
     /* remember the object, direct assignment of struct for the moment */
     copyname(&variable, &name);
+#ifdef HASCOMPACTARRAYS
+    if (variable.token == ARRAYVAR) variable.token = type;
+
+    /* a DIM cannot change the type of an array */
+    if (variable.token != STRINGVAR && arraytypeclash(&variable)) {
+      error(EVARIABLE);
+      return;
+    }
+#endif
 
     if (DEBUG)	{
       outsc("** in xdim "); outname(&variable); outspc(); outnumber(variable.token);
@@ -7305,6 +10290,18 @@ nextvariable:
     }
     x = popaddress();
 #else
+    /* number arrays with more than two dimensions */
+    if (variable.token != STRINGVAR && args > 2 && args <= MAXDIM) {
+      for (k = args - 1; k >= 0; k--) d[k] = popaddress();
+      if (!USELONGJUMP && er) return;
+      for (k = 0; k < args; k++) if (d[k] < 1) {
+          error(EORANGE);
+          return;
+        }
+      (void) createmultiarray(&variable, d, args);
+      if (!USELONGJUMP && er) return;
+      goto next;
+    }
     if (args != 1 && args != 2) {
       error(EARGS);
       return;
@@ -7354,6 +10351,9 @@ nextvariable:
     return;
   }
 
+#ifdef HASMULTIDIM
+next:
+#endif
   nexttoken();
   if (token == ',') {
     nexttoken();
@@ -7411,7 +10411,7 @@ void xtab() {
   if (!USELONGJUMP && er) return;
 
   /* negative tabs mapped to 0 */
-  if (tmp < 0) t = 0;
+  if (tmp < 0) tmp = 0;
   a = tmp;
 
   /* the runtime environment can do a true tab then ...  */
@@ -7655,6 +10655,183 @@ char* getfilename2(char d) {
 }
 
 #if defined(FILESYSTEMDRIVER)
+/*
+   Binary program images. SAVE writes one if the file name ends 
+   with .bin. The file has a header, the token memory from 0 to top
+   and then the program as text. LOAD checks the header. If the image
+   fits this interpreter, the token memory is read in one block and 
+   nothing is lexed. If it doesn't, or if the program is merged into 
+   an existing one, the image is skipped and the text is loaded.
+
+   The header is "SBI" and a version byte, numsize, addrsize, the size 
+   of token_t, the byte order, four bytes of language flags and the 
+   length of the image as 4 bytes little endian.
+*/
+#define BINHEADERSIZE 16
+#define BINVERSION 2
+
+/* the header of this interpreter for an image of length l */
+void binheader(mem_t* h, unsigned long l) {
+  address_t o = 1;
+  unsigned int f = 0, g = 0;
+
+#ifdef HASLONGNAMES
+  f |= 0x0001;
+#endif
+#ifdef HASLONGTOKENS
+  f |= 0x0002;
+#endif
+#ifdef HASFLOAT
+  f |= 0x0004;
+#endif
+#ifdef HASAPPLE1
+  f |= 0x0008;
+#endif
+#ifdef HASSTEFANSEXT
+  f |= 0x0010;
+#endif
+#ifdef HASDARTMOUTH
+  f |= 0x0020;
+#endif
+#ifdef HASSTRUCT
+  f |= 0x0040;
+#endif
+#ifdef HASMSSTRINGS
+  f |= 0x0080;
+#endif
+#ifdef HASIOT
+  f |= 0x0100;
+#endif
+#ifdef HASTIMER
+  f |= 0x0200;
+#endif
+#ifdef HASEVENTS
+  f |= 0x0400;
+#endif
+#ifdef HASERRORHANDLING
+  f |= 0x0800;
+#endif
+#ifdef HASARDUINOIO
+  f |= 0x1000;
+#endif
+#ifdef HASFILEIO
+  f |= 0x2000;
+#endif
+#ifdef HASGRAPH
+  f |= 0x4000;
+#endif
+#ifdef HASDARKARTS
+  f |= 0x8000;
+#endif
+#ifdef HASMULTIDIM
+  g |= 0x0001;
+#endif
+#ifdef HASMATRIX
+  g |= 0x0002;
+#endif
+#ifdef HASCOMPACTARRAYS
+  g |= 0x0004;
+#endif
+#ifdef HASDYNAMICSTRINGS
+  g |= 0x0008;
+#endif
+#ifdef HASMULTILINEFUNCTIONS
+  g |= 0x0010;
+#endif
+
+  h[0] = 'S';
+  h[1] = 'B';
+  h[2] = 'I';
+  h[3] = BINVERSION;
+  h[4] = numsize;
+  h[5] = addrsize;
+  h[6] = sizeof(token_t);
+  h[7] = *((mem_t*) &o);
+  h[8] = f & 0xff;
+  h[9] = (f >> 8) & 0xff;
+  h[10] = g & 0xff;
+  h[11] = (g >> 8) & 0xff;
+  h[12] = l & 0xff;
+  h[13] = (l >> 8) & 0xff;
+  h[14] = (l >> 16) & 0xff;
+  h[15] = (l >> 24) & 0xff;
+}
+
+/* does the file name end with .bin */
+mem_t binname(char* f) {
+  address_t i;
+
+  for (i = 0; f[i] != 0; i++);
+  if (i < 4) return 0;
+  f += i - 4;
+  return f[0] == '.' && btoupper(f[1]) == 'B' && btoupper(f[2]) == 'I' && btoupper(f[3]) == 'N';
+}
+
+/* write header and image to the open output file */
+void binsave() {
+  mem_t h[BINHEADERSIZE];
+  address_t a;
+
+  binheader(h, top);
+  for (a = 0; a < BINHEADERSIZE; a++) filewrite(h[a]);
+  for (a = 0; a < top; a++) filewrite(memread2(a));
+}
+
+/*
+   read an image from the open input file, returns 0 if the text is to 
+   be loaded, the file is then at the beginning of the text
+*/
+mem_t binload(char* filename) {
+  mem_t h[BINHEADERSIZE], b[BINHEADERSIZE];
+  address_t i;
+  unsigned long l;
+
+  /* no header, a text file, read it from the start */
+  for (i = 0; i < BINHEADERSIZE && fileavailable(); i++) b[i] = fileread();
+  if (i < BINHEADERSIZE || b[0] != 'S' || b[1] != 'B' || b[2] != 'I') {
+    ifileclose();
+    if (!ifileopen(filename)) error(EFILE);
+    return 0;
+  }
+
+  /* the header of another version has its own layout, the text cannot be found */
+  if (b[3] != BINVERSION) {
+    error(EFILE);
+    return 0;
+  }
+
+  /* the image does not fit or we merge, skip to the text */
+  l = (unsigned long) (unsigned char) b[12] | ((unsigned long) (unsigned char) b[13] << 8) |
+      ((unsigned long) (unsigned char) b[14] << 16) | ((unsigned long) (unsigned char) b[15] << 24);
+  binheader(h, l);
+  for (i = 3; i < BINHEADERSIZE; i++) if (h[i] != b[i]) break;
+  if (i < BINHEADERSIZE || top != 0 || l >= himem) {
+    for (; l > 0 && fileavailable(); l--) fileread();
+    return 0;
+  }
+
+  /* read the token memory in one go */
+#if !defined(USEMEMINTERFACE) && !defined(EEPROMMEMINTERFACE)
+  if (filereadblock((char*) mem, l) == l) {
+    top = l;
+    return 1;
+  }
+#else
+  for (i = 0; i < l && fileavailable(); i++) memwrite2(i, fileread());
+  if (i == l) {
+    top = l;
+    return 1;
+  }
+#endif
+
+  /* a short image, the text is lost as well, forget it and report */
+  for (i = 0; i < l; i++) memwrite2(i, 0);
+  top = 0;
+  ioer = 0;
+  error(EFILE);
+  return 0;
+}
+
 /*
  	SAVE a file either to disk or to EEPROM
 */
@@ -7682,6 +10859,9 @@ void xsave() {
       return;
     }
 
+    /* the binary image goes before the text */
+    if (binname(filename)) binsave();
+
     /* save the output mode and then save */
     push(od);
     od = OFILE;
@@ -7721,6 +10901,167 @@ void xsave() {
   token = t;
 }
 
+/*
+   The bulk loader used by LOAD. Lines arriving in ascending order
+   are appended to the program, this is the usual case. A line out of 
+   order is appended as well and the program is marked unsorted. At the 
+   end of the load the lines are sorted in the line index array and 
+   copied once in their order to the free memory above top. Then the 
+   program is moved down in one go. Later lines replace earlier ones with 
+   the same number and empty lines delete them.
+
+   Sorting needs free memory of the size of the program and an entry in 
+   the line index for each line. If this is not there, the program is 
+   sorted and the line goes through storeline().
+*/
+#if defined(LINEINDEXSIZE) && LINEINDEXSIZE>0 && !defined(EEPROMMEMINTERFACE)
+#define HASBULKSORT
+#endif
+
+address_t loadlast = 0;
+address_t loadlines = 0;
+mem_t loadsorted = 1;
+
+/* find the number of lines and the last line of the program */
+void beginload() {
+  loadlast = 0;
+  loadlines = 0;
+  loadsorted = 1;
+  here = 0;
+  while (here < top) {
+    gettoken();
+    if (token == LINENUMBER) {
+      loadlast = ax;
+      loadlines++;
+    }
+  }
+}
+
+#ifdef HASBULKSORT
+/* the end of the line starting at h */
+address_t lineend(address_t h) {
+  address_t e;
+
+  here = h;
+  gettoken();
+  while (here < top) {
+    e = here;
+    gettoken();
+    if (token == LINENUMBER) return e;
+  }
+  return top;
+}
+
+/* sort the lines and copy them to the free memory, then move them back */
+void sortload() {
+  address_t i, j, n, h, e, d;
+  lineindexentry t;
+
+  /* collect the lines in the order they were loaded */
+  n = 0;
+  here = 0;
+  while (here < top) {
+    gettoken();
+    if (token == LINENUMBER) {
+      lineindex[n].l = ax;
+      lineindex[n].h = here - addrsize - 1;
+      n++;
+    }
+  }
+
+  /* a stable insertion sort, the program is mostly sorted */
+  for (i = 1; i < n; i++) {
+    t = lineindex[i];
+    for (j = i; j > 0 && lineindex[j - 1].l > t.l; j--) lineindex[j] = lineindex[j - 1];
+    lineindex[j] = t;
+  }
+
+  /* copy the last of each line number, empty lines are dropped */
+  d = top;
+  for (i = 0, j = 0; i < n; i++) {
+    if (i + 1 < n && lineindex[i + 1].l == lineindex[i].l) continue;
+    h = lineindex[i].h;
+    e = lineend(h);
+    if (e - h == addrsize + 1) continue;
+    moveblock(h, e - h, d);
+    lineindex[j].l = lineindex[i].l;
+    lineindex[j].h = d - top;
+    d += e - h;
+    j++;
+  }
+  moveblock(top, d - top, 0);
+  top = d - top;
+
+  /* what is left in the array is the line index of the new program */
+  lineindexlength = j;
+  lineindextop = top;
+  lineindexvalid = 1;
+  lineindexfull = 0;
+  loadlines = j;
+  loadlast = j ? lineindex[j - 1].l : 0;
+  loadsorted = 1;
+}
+
+/* is there enough room to sort if a line with length l is appended */
+mem_t sortroom(address_t l) {
+  l = l * (numsize + 1) + addrsize + 1;
+  return loadlines < LINEINDEXSIZE && top + l < himem && himem - top - l > top + l;
+}
+#else
+void sortload() {}
+mem_t sortroom(address_t l) {
+  return 0;
+}
+#endif
+
+/* store one line of the load, the line number is in ax */
+void loadline() {
+  address_t l;
+
+  if (loadsorted && ax > loadlast) {
+    appendline();
+    if (er != 0) return;
+    /* an empty line beyond the end is an error like in storeline() */
+    if (top - here == addrsize + 1) {
+      top = here;
+      findline(ax);
+      return;
+    }
+    loadlast = ax;
+    loadlines++;
+    return;
+  }
+
+  for (l = 0; bi[l] != 0; l++);
+  if (sortroom(l)) {
+    appendline();
+    if (er != 0) return;
+    loadsorted = 0;
+    loadlines++;
+    return;
+  }
+
+  /* sorting walks through the program and changes ax */
+  if (!loadsorted) {
+    l = ax;
+    sortload();
+    ax = l;
+  }
+  /* loadlines may now be too high and loadlast too, this is harmless */
+  storeline();
+  loadlines++;
+}
+
+/* sort if needed, all caches see the new program */
+void endload() {
+  if (!loadsorted) sortload(); else clrlineindex();
+  clrdata();
+  clrlinecache();
+  clrlinktable();
+  clrbraketmap();
+  clrexprcache();
+}
+
 /*
    LOAD a file, LOAD can either be invoked with a filename argument
    or without, in the latter case the filename is read from the token stream
@@ -7740,6 +11081,11 @@ void xload(const char* f) {
     filename = (char*)f;
   }
 
+  /* the program is replaced, the string pool has to move away */
+#ifdef HASDYNAMICSTRINGS
+  parkstrings();
+#endif
+
   if (filename[0] == '!') {
     eload();
   } else {
@@ -7765,34 +11111,42 @@ void xload(const char* f) {
     if (!f)
       if (!ifileopen(filename)) {
         error(EFILE);
+#ifdef HASDYNAMICSTRINGS
+        unparkstrings();
+#endif
         return;
       }
 
-    bi = ibuffer + 1;
-    while (fileavailable()) {
-      ch = fileread();
+    /* a binary image needs no lexing, otherwise read the text */
+    if (!binload(filename) && er == 0) {
+      beginload();
+      bi = ibuffer + 1;
+      while (fileavailable()) {
+        ch = fileread();
 
-      if (ch == '\n' || ch == '\r' || cheof(ch)) {
-        *bi = 0;
-        bi = ibuffer + 1;
-        if (*bi != '#') { /* lines starting with a # are skipped - Unix style shell startup */
-          nexttoken();
-          if (token == NUMBER) {
-            ax = x;
-            storeline();
-          }
-          if (er != 0 ) break;
+        if (ch == '\n' || ch == '\r' || cheof(ch)) {
+          *bi = 0;
           bi = ibuffer + 1;
+          if (*bi != '#') { /* lines starting with a # are skipped - Unix style shell startup */
+            nexttoken();
+            if (token == NUMBER) {
+              ax = x;
+              loadline();
+            }
+            if (er != 0 ) break;
+            bi = ibuffer + 1;
+          }
+        } else {
+          *bi++ = ch;
         }
-      } else {
-        *bi++ = ch;
-      }
 
-      if ((bi - ibuffer) > BUFSIZE) {
-        error(EOUTOFMEMORY);
-        break;
+        if ((bi - ibuffer) > BUFSIZE) {
+          error(EOUTOFMEMORY);
+          break;
+        }
       }
     }
+    endload();
     ifileclose();
     /* after a successful load we save top to the EEPROM header */
 #ifdef EEPROMMEMINTERFACE
@@ -7806,6 +11160,10 @@ void xload(const char* f) {
       nexttoken();
     }
   }
+
+#ifdef HASDYNAMICSTRINGS
+  unparkstrings();
+#endif
 }
 #else
 /*
@@ -8695,11 +12053,13 @@ void resettimer(btimer_t* t) {
   t->last = 0;
   t->type = 0;
   t->linenumber = 0;
+  t->target = 0;
 }
 
 void xtimer() {
   token_t t;
   btimer_t* timer;
+  address_t a;
 
   /* do we deal with every or after */
   if (token == TEVERY) timer = &every_timer; else timer = &after_timer;
@@ -8713,9 +12073,11 @@ void xtimer() {
     case TGOSUB:
     case TGOTO:
       t = token;
+      a = here;
       if (!expectexpr()) return;
       timer->last = millis();
       timer->type = t;
+      timer->target = linktarget(a);
       timer->linenumber = pop();
       timer->interval = pop();
       timer->enabled = 1;
@@ -8833,6 +12195,7 @@ void xevent() {
   mem_t pin, mode;
   mem_t type = 0;
   address_t line = 0;
+  address_t a = 0;
 
   /* in this version two arguments are neded, one is the pin, the second the mode */
   nexttoken();
@@ -8900,6 +12263,7 @@ void xevent() {
     type = token;
 
     /* which line to go to */
+    a = here;
     if (!expectexpr()) return;
     line = pop();
   } else {
@@ -8921,6 +12285,9 @@ void xevent() {
     return;
   }
 
+  /* the linked target of the event */
+  eventlist[eventindex(pin)].target = linktarget(a);
+
   /* enable the interrupt */
   if (!enableevent(pin)) {
     deleteevent(pin);
@@ -8959,6 +12326,7 @@ slotfound:
   eventlist[i].type = type;
   eventlist[i].linenumber = linenumber;
   eventlist[i].active = 0;
+  eventlist[i].target = 0;
   return 1;
 }
 
@@ -8975,6 +12343,7 @@ void deleteevent(mem_t pin) {
     eventlist[i].type = 0;
     eventlist[i].linenumber = 0;
     eventlist[i].active = 0;
+    eventlist[i].target = 0;
     nevents--;
   }
 }
@@ -9304,6 +12673,11 @@ void xusr() {
           push(avgfastticker()); 
           clearfasttickerprofile();
           break;
+#endif
+#if defined(HASAPPLE1) && defined(HEAPCACHESIZE) && HEAPCACHESIZE > 0
+        case 36: push(heapcachehits); break;
+        case 37: push(heapcachemisses); break;
+        case 38: push(HEAPCACHESIZE); break;
 #endif
         /* - 48 reserved, don't use */
         case 48: push(id); break;
@@ -9568,6 +12942,12 @@ nextdata:
         else assignnumber2(&lhs, *sr.ir);
       } else {
         /* we have all we need in sr */
+        /* dynamic strings need room for the data */
+#ifdef HASDYNAMICSTRINGS
+        reservestring(&lhs.name, lhs.j, lhs.i + sr.length - 1, &sr);
+        if (!USELONGJUMP && er) return;
+#endif
+
         /* the destination address of the lefthandside, on the fly create included */
         getstring(&s, &lhs.name, lhs.i, lhs.j);
         if (!USELONGJUMP && er) return;
@@ -9833,7 +13213,8 @@ void xfn(mem_t m) {
 
   /* what is the name of the variable, direct read as getname also gets a token */
   /* skip the type here as not needed*/
-  // zeroname(&variable); /* fixes the obscure function namehandling bug not needed any more with copyname in place */
+  /* functions without argument store an empty name, getname then leaves c[] untouched */
+  zeroname(&variable);
   variable.token = memread2(a++);
   (void) getname(a, &variable, memread2);
   a = a + sizeof(name_t) - 1;
@@ -9932,6 +13313,7 @@ void xon() {
   int ci;
   token_t t;
   int line = 0;
+  address_t a;
 
   /*  ON can do the ON ERROR and ON EVENT commands as well, in this BASIC
   		ERROR and EVENT can also be used without the ON */
@@ -9967,8 +13349,9 @@ void xon() {
     return;
   }
 
-  /* remember if we do gosub or goto */
+  /* remember if we do gosub or goto and where the list starts */
   t = token;
+  a = here;
 
   /* how many arguments have we got here */
   nexttoken();
@@ -10014,7 +13397,9 @@ void xon() {
   if (t == TGOSUB) pushgosubstack(0);
   if (!USELONGJUMP && er) return;
 
-  findline(line);
+  /* a linked list has only constants, element ci is found at a fixed offset */
+  if (linktarget(a)) a = linktarget(a + (ci - 1) * (numsize + 2)); else a = 0;
+  findlinetarget(line, a);
   if (!USELONGJUMP && er) return;
 
   /* goto in interactive mode switched to RUN mode
@@ -10361,6 +13746,11 @@ void statement() {
       case TDIM:
         xdim();
         break;
+#ifdef HASMATRIX
+      case TMAT:
+        xmat();
+        break;
+#endif
       case TCLR:
         xclr();
         break;
@@ -10701,7 +14091,7 @@ errorhandler:
             if (token == LINENUMBER) here -= (1 + sizeof(address_t));
             pushgosubstack(0);
           }
-          findline(after_timer.linenumber);
+          findlinetarget(after_timer.linenumber, after_timer.target);
           if (er) return;
         }
       }
@@ -10715,7 +14105,7 @@ errorhandler:
             pushgosubstack(0);
             if (er) return;
           }
-          findline(every_timer.linenumber);
+          findlinetarget(every_timer.linenumber, every_timer.target);
           if (er) return;
         }
       }
@@ -10732,7 +14122,7 @@ errorhandler:
               pushgosubstack(TEVENT);
               if (er) return;
             }
-            findline(eventlist[ievent].linenumber); /* here we jump to the new line */
+            findlinetarget(eventlist[ievent].linenumber, eventlist[ievent].target); /* here we jump to the new line */
             if (er) return;
             eventlist[ievent].active = 0;
             enableevent(eventlist[ievent].pin); /* events are disabled in the interrupt function, here they are activated again */
@@ -10867,6 +14257,10 @@ void loop() {
 #ifndef EEPROMMEMINTERFACE
     top = 0;
 #endif
+    clrlineindex();
+    clrlinktable();
+    clrbraketmap();
+    clrexprcache();
     st = SINT;
   } else if (st == SRUN) {
     here = 0;
@@ -22,6 +22,13 @@
  * #define GOSUBDEPTH      
  * #define FORDEPTH        
  * #define LINECACHESIZE
+ * #define HEAPINDEXSIZE
+ * #define HEAPCACHESIZE
+ * #define HEAPCACHEWAYS
+ * #define ARRAYCACHESIZE
+ * #define LINEINDEXSIZE
+ * #define LINKTABLESIZE
+ * #define BRAKETMAPSIZE
  * 
  * They depend on the hardware architecture and are configured there.
  *
@@ -38,6 +45,9 @@
 /* the maximum name length */
 #define MAXNAME         32
 
+/* the maximum number of array dimensions with HASMULTIDIM */
+#define MAXDIM          8
+
 /*
  * The tokens for the BASIC keywords
  *
@@ -216,6 +226,18 @@
 #define TSHL 9
 #define TSHR 11
 #define TBIT 12
+
+/* MAT statements and array reductions, 13 is avoided like 10 */
+#define TMAT 14
+#define TZER 15
+#define TCON 16
+#define TSUM 17
+#define TMIN 18
+#define TMAX 19
+
+/* compact arrays, INT is the third type */
+#define TBYTE 20
+#define TLONG 21
 /* 
  * Extension tokens can be in the range from -128 upwards.
  * one needs to set HASLONGTOKENS. Currently ony one set of 
@@ -300,9 +322,11 @@
 #ifdef HAS64BIT
 typedef double number_t;
 typedef long long wnumber_t;
+typedef long double scale_t;
 #else
 typedef float number_t;
 typedef long long wnumber_t;
+typedef double scale_t;
 #endif
 #else
 #ifdef HAS64BIT
@@ -381,7 +405,7 @@ typedef struct {
  *      arrays and strings.
  * 
  * Currently name_t only implements two letter objects and lhsobject_t
- * only implements two dimensional arrays and one dimensional strings.
+ * implements arrays up to MAXDIM dimensions and one dimensional strings.
  */
 typedef struct { 
     token_t token; 
@@ -396,6 +420,10 @@ typedef struct {
     address_t j;    /*  the second index of an array */
     address_t i2;   /* the second value of a substring string */
     mem_t ps;       /* flag to indicate a pure string */
+#ifdef HASMULTIDIM
+    mem_t dims;     /* the number of array indices */
+    address_t k[MAXDIM - 2]; /* the third and further indices of an array */
+#endif
 } lhsobject_t;
 
 /* heap objects have a name a size and a payload address */
@@ -405,6 +433,22 @@ typedef struct {
     address_t size; 
 } heap_t;
 
+/* 
+ * resolved arrays have a name, the payload address, the number of elements, 
+ * the row length, the number of dimensions, the address of the dimension 
+ * table, the heap token as type and the element size
+ */
+typedef struct {
+    name_t name;
+    address_t address;
+    address_t size;
+    address_t dim;
+    mem_t dims;
+    address_t table;
+    token_t type;
+    mem_t esize;
+} array_t;
+
 /* 
  * a general loop time, needed for the reimplementation of all loops 
  * the loop time knows the variable of a for loop or alternatively 
@@ -420,12 +464,30 @@ typedef struct {
     number_t step;
 } bloop_t;
 
+/*
+ * The integer fast path only makes sense with floats. exint_t
+ * holds every integer a number_t represents exactly.
+ */
+#ifndef HASFLOAT
+#undef HASINTEGERPATH
+#endif
+#ifdef HASINTEGERPATH
+#ifdef HAS64BIT
+typedef long long exint_t;
+#else
+typedef long exint_t;
+#endif
+#endif
+
 /* 
  * The accumulator type, used for the stack and the 
  * arithmetic operations. 
  */
 typedef union { 
     number_t n; 
+#ifdef HASINTEGERPATH
+    exint_t l;
+#endif
     address_t a; 
     index_t i;
     stringlength_t s; 
@@ -439,6 +501,7 @@ typedef struct {
     unsigned long interval; 
     mem_t type;
     address_t linenumber;
+    address_t target;
 } btimer_t;
 
 /* 
@@ -461,6 +524,7 @@ typedef struct {
     mem_t type;
     address_t linenumber;
     mem_t active;
+    address_t target;
 } bevent_t;
 
 /* 
@@ -505,6 +569,13 @@ address_t bmalloc(name_t*, address_t);
 address_t bfind(name_t*);
 address_t bfree(name_t*);
 address_t blength (name_t*);
+address_t bheapobject(address_t);
+
+/* the optional index and cache of the heap objects */
+address_t bnamehash(name_t*);
+void clrheapindex();
+void clrheapcache();
+void clrarraycache();
 
 /* normal variables of number_t */
 number_t getvar(name_t*);
@@ -512,6 +583,9 @@ void setvar(name_t*, number_t);
 void clrvars();
 
 /* the new set of functions for memory access */
+number_t memgetnumber(address_t);
+address_t memgetaddress(address_t);
+address_t memgetname(address_t, name_t*);
 number_t getnumber(address_t, memreader_t);
 address_t getaddress(address_t, memreader_t); 
 stringlength_t getstrlength(address_t, memreader_t);
@@ -528,9 +602,43 @@ void zeroname(name_t*);
 void zeroheap(heap_t*);
 
 /* array and string handling */
-/* the multidim extension is experimental, here only 2 array dimensions implemented as test */
+/* the multidim extension, arrays with two or more dimensions and string arrays */
+mem_t elementsize(token_t);
 address_t createarray(name_t*, address_t, address_t);
+#ifdef HASCOMPACTARRAYS
+address_t findcompact(name_t*);
+mem_t arraytypeclash(name_t*);
+number_t getelement(address_t, token_t);
+void setelement(address_t, token_t, number_t);
+#endif
+#ifdef HASMULTIDIM
+address_t createmultiarray(name_t*, address_t*, mem_t);
+address_t arraycolumn(lhsobject_t*, array_t*, address_t);
+#endif
 void array(lhsobject_t*, mem_t, number_t*);
+address_t findarray(name_t*, array_t*);
+#ifdef HASMATRIX
+char matname(name_t*);
+number_t matget(array_t*, address_t);
+void matset(array_t*, address_t, number_t);
+void matcompute(token_t, array_t*, array_t*, array_t*, number_t);
+number_t matreduce(token_t, array_t*);
+mem_t matshape(array_t*, array_t*);
+void matcreate(name_t*, array_t*);
+void xmat();
+void factormat();
+#endif
+#ifdef HASDYNAMICSTRINGS
+void strmoveblock(address_t, address_t, address_t);
+void strzeroblock(address_t, address_t);
+void compactstrings(string_t*);
+void freestrings(address_t, address_t);
+address_t stringdescriptor(name_t*, address_t);
+void reservestring(name_t*, address_t, address_t, string_t*);
+void trimstring(name_t*, address_t);
+void parkstrings();
+void unparkstrings();
+#endif
 address_t createstring(name_t*, address_t, address_t);
 void getstring(string_t*, name_t*, address_t, address_t);
 void setstringlength(name_t*, address_t, address_t);
@@ -548,6 +656,10 @@ void usrcall(address_t);
 char* getkeyword(address_t);
 char* getmessage(char);
 token_t gettokenvalue(address_t);
+address_t keywordgroup(char);
+void buildkeywordindex();
+address_t matchkeyword(address_t, char*);
+address_t findkeyword(char*, address_t*);
 void printmessage(char);
 
 /* error handling */
@@ -605,6 +717,10 @@ address_t parsenumber2(char*, number_t*);
 address_t writenumber(char*, wnumber_t); 
 address_t writenumbern(char*, wnumber_t, mem_t); /* can do hex,oct,bin */
 address_t writenumber2(char*, number_t);
+#ifdef HASFLOAT
+scale_t powten(index_t);
+address_t writeshortest(char*, number_t);
+#endif
 address_t tinydtostrf(number_t, index_t, char*);
 int innumber(number_t*, char*, address_t);
 void outnumber(number_t);
@@ -617,6 +733,7 @@ void outnumber(number_t);
 
 /* lexical analysis */
 void whitespaces();
+char btoupper(char);
 void nexttoken();
 
 /* storing and retrieving programs */
@@ -627,19 +744,32 @@ mem_t memread2(address_t);
 void memwrite2(address_t, mem_t);
 mem_t beread(address_t);
 void beupdate(address_t, mem_t);
+void gettokenram();
 void gettoken();
 void firstline();
 void nextline();
 
 void clrlinecache();
+void clrlineindex();
 void addlinecache(address_t, address_t);
 address_t findinlinecache(address_t);
 void findline(address_t);
+void findlinetarget(address_t, address_t);
+void clrlinktable();
+void buildlinktable();
+address_t linktarget(address_t);
 address_t myline(address_t);
 void moveblock(address_t, address_t, address_t);
 void zeroblock(address_t, address_t);
 void diag();
 void storeline();
+void storeline2();
+void appendline();
+mem_t foldterm(token_t);
+mem_t foldopen(token_t);
+mem_t foldvalue(token_t, number_t, number_t, number_t*);
+void foldstore(address_t, address_t, number_t);
+void foldline(address_t);
 
 /* read arguments from the token stream and process them */
 char termsymbol();
@@ -648,6 +778,9 @@ char expectexpr();
 void parsearguments();
 void parsenarguments(char);
 void parsesubscripts();
+#ifdef HASMULTIDIM
+void popindices(lhsobject_t*);
+#endif
 void parsefunction(void (*)(), short);
 void parseoperator(void (*)());
 void parsesubstring();
@@ -687,6 +820,29 @@ void notexpression();
 void andexpression();
 void expression();
 
+/* the expression cache */
+void clrexprcache();
+address_t exprslot(address_t);
+mem_t exprput(void*, address_t);
+mem_t exprop(unsigned char);
+void exprnext();
+mem_t cparseoperator(mem_t (*)());
+mem_t cfactor();
+mem_t cpower();
+mem_t cterm();
+mem_t caddexpression();
+mem_t ccompexpression();
+mem_t cnotexpression();
+mem_t candexpression();
+mem_t cexpression();
+void exprcompile(address_t);
+number_t exprnumber(unsigned char);
+#ifdef HASINTEGERPATH
+mem_t exprinteger(unsigned char, exint_t*, exint_t);
+#endif
+void exprrun(unsigned char*, index_t);
+mem_t exprcached();
+
 /* real time clock string stuff */
 void rtcmkstr();
 
@@ -711,6 +867,7 @@ void xif();
 /* FOR NEXT loops */
 void findnextcmd();
 void findbraket(token_t, token_t);
+void clrbraketmap();
 void xfor();
 void xbreak();
 void xcont();
@@ -741,8 +898,18 @@ void xlocate();
 /* file access and other i/o */
 void stringtobuffer(char*, string_t*);
 void getfilename(char*, char);
+void binheader(mem_t*, unsigned long);
+mem_t binname(char*);
+void binsave();
+mem_t binload(char*);
 void xsave();
 void xload(const char*);
+void beginload();
+address_t lineend(address_t);
+void sortload();
+mem_t sortroom(address_t);
+void loadline();
+void endload();
 void xget();
 void xput();
 void xset();
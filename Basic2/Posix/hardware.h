@@ -30,12 +30,32 @@
 #undef RASPPI
 #define POSIX
 
+/*
+ * Numeric personalities of the POSIX build. The default is the float
+ * interpreter. Define one of these on the compiler command line for
+ * another one, e.g. cc -DPOSIXINT64 basic.c runtime.c -lm
+ *
+ * POSIXDOUBLE: 64 bit double numbers
+ * POSIXINT: integer numbers, int is 32 bit on all POSIX systems
+ * POSIXINT64: 64 bit integer numbers with 32 bit addresses and 1 MB 
+ *	of BASIC memory, for exact arithmetic on large data sets
+ *
+ * test/benchscript builds all of them and compares their speed.
+ */
+#if defined(POSIXINT) || defined(POSIXINT64)
+#define POSIXNOFLOAT
+#endif
+
 /*
  *	MEMSIZE sets the BASIC main memory to a fixed value,
  *		if MEMSIZE=0 a heuristic is used based on free heap
  *		size and architecture parameters
  */
+#ifndef POSIXINT64
 #define MEMSIZE 0
+#else
+#define MEMSIZE 1048576
+#endif
 
 /* 
  * Hardware flags of the POSIX systems 
@@ -51,6 +71,7 @@
  * POSIXMQTT: analogous to ARDUINOMQTT, send and receive MQTT messages (unfinished)
  * POSIXWIRING: use the (deprectated) wiring code for gpio on Raspberry Pi
  * POSIXPIGPIO: use the pigpio library on a Raspberry PI  - currently broken - wire change - don't use
+ * POSIXMMAP: read binary program images with mmap
  * ESP32CAMERA: a stub to help with development of the MCU code
  */
 
@@ -63,6 +84,7 @@
 #undef POSIXMQTT
 #undef POSIXWIRING
 #undef POSIXPIGPIO
+#define POSIXMMAP
 #define ESP32CAMERA
 
 /* simulates SPI RAM, only test code, keep undefed if you don't want to do something special */
@@ -171,6 +193,7 @@ unsigned long millis();
 /* the ususal suspects */
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
 /* floating point maths only needed if HASFLOAT*/
 #include <math.h>
@@ -195,6 +218,15 @@ unsigned long millis();
 #include <windows.h>
 #endif
 
+/* memory mapped files, not on DOS and Windows */
+#if defined(MSDOS) || defined(MINGW)
+#undef POSIXMMAP
+#endif
+#ifdef POSIXMMAP
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
 /* 
  *  Tell BASIC we have a second serial port
  */
@@ -231,12 +263,30 @@ unsigned long millis();
 #define GOSUBDEPTH      64
 #define FORDEPTH        64
 #define LINECACHESIZE   64
+#define LINEINDEXSIZE   4096
+#define LINKTABLESIZE   1024
+#define BRAKETMAPSIZE   256
+#define EXPRCACHESIZE   256
+#define EXPRCODESIZE    4096
+#define HEAPINDEXSIZE   256
+#define HEAPCACHESIZE   16
+#define HEAPCACHEWAYS   4
+#define ARRAYCACHESIZE  4
 #else
 #define BUFSIZE         256
 #define STACKSIZE       256
 #define GOSUBDEPTH      196
 #define FORDEPTH        196
 #define LINECACHESIZE   196
+#define LINEINDEXSIZE   16384
+#define LINKTABLESIZE   4096
+#define BRAKETMAPSIZE   1024
+#define EXPRCACHESIZE   1024
+#define EXPRCODESIZE    16384
+#define HEAPINDEXSIZE   1024
+#define HEAPCACHESIZE   64
+#define HEAPCACHEWAYS   4
+#define ARRAYCACHESIZE  4
 #endif
 
 /* the buffer size for simulated serial RAM */
@@ -247,6 +297,29 @@ unsigned long millis();
  */
 #define FASTTICKERPROFILE
 
+/*
+ * Index the keywords by their first character, speeds up the lexer.
+ */
+#define HASKEYWORDINDEX
+
+/*
+ * Fold constant expressions like 60*60 when a line is stored.
+ */
+#define HASCONSTFOLD
+
+/*
+ * Keep integers as integers in compiled expressions of float builds.
+ * This pays off on boards with software floating point, with a 
+ * floating point unit the conversions cost more than they save.
+ */
+#undef HASINTEGERPATH
+
+/*
+ * Number conversion builds the powers of ten from a small table 
+ * instead of keeping all of them, for boards short of flash.
+ */
+#undef SMALLPOWERTABLE
+
 /*
  * Does the platform has command line args and do we want to use them 
  */
@@ -259,5 +332,9 @@ unsigned long millis();
 #define FNLIMIT 128
 
 /* all POSIXish systems can do the full interpreter, only here for compatibility with Arduino */
+#ifndef POSIXNOFLOAT
 #define BASICFULL
+#else
+#define BASICINTEGER
+#endif
 
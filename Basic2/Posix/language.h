@@ -73,7 +73,7 @@
  * HASDARKARTS: Dark Arts BASIC is MALLOC, FIND, CLR for individual variables and EVAL for self modifying code.
  * HASIOT: IoT functions, Wire access, Sensor functions, MQTT. Needs strings and heap. STR, VAL, INSTR are 
  *  part of this. MQTT support only on Arduino-
- * HASMULTIDIM: two dimensional arrays and one dimensional string arrays.
+ * HASMULTIDIM: arrays with up to MAXDIM dimensions and one dimensional string arrays.
  * HASTIMER: timer functions, AFTER and EVERY for periodic execution of programs.
  * HASEVENTS: event handling, EVENT command. 
  * HASERRORHANDLING: error handling with ERROR GOTO.
@@ -97,6 +97,10 @@
  * HASNUMSYSTEM: constants can be hex, octal, binary or decimal. This is not activated by 
  *  default. Currently only implemented in VAL() and STR().
  * HASBITWISE: has bitwise operations >>, << and the function BIT -> removed and default now.
+ * HASMATRIX: MAT statements on whole arrays, MAT A=B+C, A=B-C, A=B*k, A=ZER, A=CON 
+ *  and the reductions SUM(A), MIN(A), MAX(A). They run in C instead of BASIC loops.
+ * HASCOMPACTARRAYS: arrays of bytes, 16 bit and 32 bit integers with DIM BYTE A(n), 
+ *  DIM INT A(n) and DIM LONG A(n). They need 1, 2 or 4 bytes per element.
  * 
  * If you want to set everything manually, set NOLANGUAGEHEURISTICS above
  */
@@ -128,6 +132,8 @@
 #define HASFULLINSTR
 #define HASLOOPOPT
 #define HASNUMSYSTEM
+#define HASMATRIX
+#define HASCOMPACTARRAYS
 #define HASCAMERA
 #endif
 
@@ -162,6 +168,14 @@
  * HASPOWER: the POWER operator ^ is available in addition to the POW function.
  * HASUSRCALL: the USR and CALL functions. On small systems they need a lot 
  *      of flash and can be disabled.
+ * HASSTACKREGISTER: compiled expressions keep the top of the stack in a 
+ *      register and check the stack depth once per expression instead of 
+ *      in every push and pop. Needs the expression cache.
+ * HASDYNAMICSTRINGS: strings live in a string pool above the program and 
+ *      take only the bytes they need. The heap only keeps a descriptor per 
+ *      string. DIM A$(n) sets no maximum length any more, strings grow up to 
+ *      the limit of the string index size. Unused bytes are collected when 
+ *      the pool runs full. Not for programs stored in EEPROM.
  */
 
 #undef POWERRIGHTTOLEFT
@@ -169,10 +183,16 @@
 #undef SUPPRESSSUBSTRINGS
 #define USELONGJUMP 0
 #define BOOLEANMODE -1
+#if defined(POSIXDOUBLE) || defined(POSIXINT64)
+#define HAS64BIT
+#else
 #undef  HAS64BIT
+#endif
 #undef  HAS32BITINT
 #define HASPOWER 
 #define HASUSRCALL
+#define HASSTACKREGISTER
+#undef  HASDYNAMICSTRINGS
 
 /* Palo Alto plus Arduino functions */
 #ifdef BASICMINIMAL
@@ -202,6 +222,8 @@
 #undef HASFULLINSTR
 #undef HASLOOPOPT
 #undef HASNUMSYSTEM
+#undef HASMATRIX
+#undef HASCOMPACTARRAYS
 #undef HASPOWER
 #undef HASUSRCALL
 #undef HASCAMERA
@@ -234,6 +256,8 @@
 #undef HASHELP
 #undef HASLOOPOPT
 #undef HASNUMSYSTEM
+#undef HASMATRIX
+#undef HASCOMPACTARRAYS
 #undef HASBITWISE
 #undef HASFULLINSTR
 #undef HASLOOPOPT
@@ -271,6 +295,8 @@
 #define HASFULLINSTR
 #define HASLOOPOPT
 #define HASNUMSYSTEM
+#define HASMATRIX
+#define HASCOMPACTARRAYS
 #undef  HASCAMERA
 #endif
 
@@ -302,6 +328,8 @@
 #undef HASFULLINSTR
 #undef HASLOOPOPT
 #undef HASNUMSYSTEM
+#undef HASMATRIX
+#undef HASCOMPACTARRAYS
 #undef HASPOWER
 #undef HASUSRCALL
 #undef HASCAMERA
@@ -335,6 +363,8 @@
 #undef HASFULLINSTR
 #undef HASLOOPOPT
 #undef HASNUMSYSTEM
+#undef HASMATRIX
+#undef HASCOMPACTARRAYS
 #undef HASPOWER
 #undef HASUSRCALL
 #undef HASCAMERA
@@ -369,6 +399,8 @@
 #define HASFULLINSTR
 #define HASLOOPOPT
 #define HASNUMSYSTEM
+#define HASMATRIX
+#define HASCOMPACTARRAYS
 #define HASCAMERA
 #endif
 
@@ -400,6 +432,8 @@
 #undef HASFULLINSTR
 #undef HASLOOPOPT
 #undef HASNUMSYSTEM
+#undef HASMATRIX
+#undef HASCOMPACTARRAYS
 #undef HASPOWER
 #undef HASUSRCALL
 #undef HASCAMERA
@@ -433,6 +467,8 @@
 #undef HASFULLINSTR
 #undef HASLOOPOPT
 #undef HASNUMSYSTEM
+#undef HASMATRIX
+#undef HASCOMPACTARRAYS
 #undef HASPOWER
 #undef HASUSRCALL
 #undef HASCAMERA
@@ -453,7 +489,7 @@
 #define HASDARTMOUTH
 #endif
 
-#if defined(HASDARTMOUTH) || defined(HASDARKARTS) || defined(HASIOT) || defined(HASMSSTRINGS)
+#if defined(HASDARTMOUTH) || defined(HASDARKARTS) || defined(HASIOT) || defined(HASMSSTRINGS) || defined(HASMATRIX) || defined(HASCOMPACTARRAYS)
 #define HASAPPLE1
 #endif
 
@@ -461,12 +497,21 @@
 #define HASSTEFANSEXT
 #endif
 
+/* dynamic strings are a different way to store the Apple 1 strings */
+#if !defined(HASAPPLE1)
+#undef HASDYNAMICSTRINGS
+#endif
+
 /* MS strings also bring the full INSTR */
 #if defined(HASMSSTRINGS)
 #define HASFULLINSTR
 #endif
 
 /* dependencies on the hardware */
+#if defined(EEPROMMEMINTERFACE)
+#undef HASDYNAMICSTRINGS
+#endif
+
 #if !defined(DISPLAYHASGRAPH) 
 #undef HASGRAPH
 #endif
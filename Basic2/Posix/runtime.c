@@ -551,12 +551,40 @@ void outch(char c) {
 /*
  *  outs() outputs a string of length x at index ir - basic style
  *  default is a character by character operation, block 
- *  oriented write needs special functions
+ *  oriented write needs special functions. Serial, printer and 
+ *  files are written as blocks and yield once per string.
  */
 void outs(char *ir, uint16_t l){
   uint16_t i;
 
+/* the tab counting of outch() for the block devices */
+#ifdef HASMSTAB
+#ifdef POSIXPRT
+  if (od == OSERIAL || od == OPRT) {
+#else
+  if (od == OSERIAL) {
+#endif
+    for(i=0; i<l; i++) {
+      if (ir[i] > 31) charcount[od]+=1;
+      if (ir[i] == 10) charcount[od]=0;
+    }
+  }
+#endif
+
   switch (od) {
+  case OSERIAL:
+    serialouts(ir, l);
+    break;
+#ifdef POSIXPRT
+  case OPRT:
+    prtouts(ir, l);
+    break;
+#endif
+#ifdef FILESYSTEMDRIVER
+  case OFILE:
+    fileouts(ir, l);
+    break;
+#endif
 #ifdef HASRF24
   case ORADIO:
     radioouts(ir, l);
@@ -580,7 +608,7 @@ void outs(char *ir, uint16_t l){
   default:
     for(i=0; i<l; i++) outch(ir[i]);
   }
-  byield(); /* triggers yield after each character output */
+  byield(); /* yield once per string, outch() also yields */
 }
 
 
@@ -1267,6 +1295,14 @@ void filewrite(char c) {
     ioer=1;
 }
 
+/* write a block of characters with one call */
+void fileouts(char* b, uint16_t l) {
+  if (ofile) { 
+    if (fwrite(b, 1, l, ofile) != l) ioer=1; 
+  } else 
+    ioer=1;
+}
+
 char fileread(){
   char c;
 /* the buildin file is active, we handle this first, else we allow for another FS */
@@ -1354,6 +1390,39 @@ int fileavailable(){
   return !feof(ifile); 
 }
 
+/* 
+ * read a block from the input file, used for binary program images
+ * with POSIXMMAP the file is mapped and the block copied in one go
+ */
+size_t filereadblock(char* b, size_t n) {
+  size_t i;
+#ifdef POSIXMMAP
+  struct stat sb;
+  long o;
+  char* p;
+
+  if (ifile
+#if defined(HASBUILDIN)
+    && !buildin_ifile
+#endif
+    ) {
+    o = ftell(ifile);
+    if (o >= 0 && fstat(fileno(ifile), &sb) == 0 && o + n <= sb.st_size) {
+      p = mmap(0, o + n, PROT_READ, MAP_PRIVATE, fileno(ifile), 0);
+      if (p != MAP_FAILED) {
+        memcpy(b, p + o, n);
+        munmap(p, o + n);
+        fseek(ifile, o + n, SEEK_SET);
+        return n;
+      }
+    }
+  }
+#endif
+  for (i = 0; i < n && fileavailable(); i++) b[i] = fileread();
+  if (i < n) ioer = 1;
+  return i;
+}
+
 /*
  * directory handling for the catalog function
  * these methods are needed for a walkthtrough of 
@@ -1859,6 +1928,28 @@ void serialwrite(char c) {
   putchar(c);
 }
 
+/* would serialwrite() just put the character out */
+uint8_t serialplain(char c) {
+#ifdef POSIXVT52TOANSI
+  if (dspesc || (c == 27 && vt52active)) return 0;
+#endif
+#ifdef POSIXTERMINAL
+  if (c == 12 || c == 2) return 0;
+#endif
+  return 1;
+}
+
+/* write runs of plain characters as a block, the rest through serialwrite() */
+void serialouts(char* b, uint16_t l) {
+  uint16_t i, j;
+
+  for (i=0; i<l; i=j) {
+    for (j=i; j<l && serialplain(b[j]); j++);
+    if (j > i) fwrite(b+i, 1, j-i, stdout);
+    if (j < l) serialwrite(b[j++]);
+  }
+}
+
 /* 
  * handling the second serial interface - only done on Mac so far 
  * test code
@@ -1941,6 +2032,12 @@ void prtwrite(char c) {
   if (i != 1) ioer=1;
 }
 
+/* or an entire string at once */
+void prtouts(char* b, uint16_t l) {
+  int i=write(prtfile, b, l);
+  if (i != l) ioer=1;
+}
+
 /* read just one byte, map no bytes to EOF = -1 */
 char prtread() {
   char c;
@@ -1983,6 +2080,7 @@ void prtbegin() {}
 uint8_t prtstat(uint8_t c) {return 0; }
 void prtset(uint32_t s) {}
 void prtwrite(char c) {}
+void prtouts(char* b, uint16_t l) {}
 char prtread() {return 0;}
 char prtcheckch(){ return 0; }
 uint16_t prtavailable(){ return 0; }
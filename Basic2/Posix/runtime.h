@@ -455,6 +455,7 @@ typedef int PinStatus;
   *  Picoserial is not character oriented. It read one entire line. 
   * serialstat(s): check the status of the serial port
   * serialwrite(c): write a character to the serial port
+  * serialouts(s, l): write a string of length l to the serial port
   * serialcheckch(): check if a character is available without blocking
   * serialavailable(): check if characters are available
   * serialflush(): flush the serial port
@@ -465,6 +466,7 @@ typedef int PinStatus;
  char serialread();
  uint8_t serialstat(uint8_t); /* state information on the serial port */
  void serialwrite(char); /* write to a serial stream */
+ void serialouts(char*, uint16_t); /* write a block to a serial stream */
  char serialcheckch(); /* check on a character, needed for breaking */
  uint16_t serialavailable(); /* avail method, needed for AVAIL() */ 
  void serialflush(); /* flush serial */
@@ -846,6 +848,7 @@ uint16_t kbdins(char*, uint16_t);
   * prtclose(): close the serial port
   * prtstat(s): check the status of the serial port
   * prtwrite(c): write a character to the serial port
+  * prtouts(s, l): write a string of length l to the serial port
   * prtread(): read a character from the serial port
   * prtcheckch(): check if a character is available without blocking
   * prtavailable(): check if characters are available
@@ -858,6 +861,7 @@ uint16_t kbdins(char*, uint16_t);
   void prtclose();
   uint8_t prtstat(uint8_t);
   void prtwrite(char);
+  void prtouts(char*, uint16_t);
   char prtread();
   char prtcheckch();
   uint16_t prtavailable();
@@ -1065,8 +1069,10 @@ int16_t wirereadbyte();
   *	File I/O function on an Arduino:
   * 
   *  filewrite(c): write a character to a file
+  *  fileouts(s, l): write a string of length l to a file
   *  fileread(): read a character from a file
   *  fileavailable(): check if a character is available in the file
+ *  filereadblock(b, n): read a block of n bytes from a file to b
   *  ifileopen(s): open a file for input
   *  ifileclose(): close a file for input
   *  ofileopen(s, m): open a file for output with mode m
@@ -1077,8 +1083,10 @@ int16_t wirereadbyte();
   */
  
  void filewrite(char);
+ void fileouts(char*, uint16_t);
  char fileread();
  int fileavailable(); /* is int because some of the fs do this */
+ size_t filereadblock(char*, size_t);
  uint8_t ifileopen(const char*);
  void ifileclose();
  uint8_t ofileopen(const char*, const char*);
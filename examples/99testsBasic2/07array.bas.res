@@ -48,14 +48,14 @@ Testing indexing A(I), B() is zero
 Testing A(2)
 127  = 127
 Autodimensioning C
-1 5.74858E-6
-2 0.72782
-3 0.6201
+1 5.74859E-6
+2 0.72783
+3 0.62011
 4 0.59269
 5 2.51519
-6 4.61416
-7 4.76449
-8 1.50486
+6 4.61417
+7 4.7645
+8 1.50487
 9 4.63455
 10 9.2524
 Testing B() and @()
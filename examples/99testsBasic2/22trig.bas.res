@@ -1,19 +1,19 @@
 X    SIN(X)       COS(X)       TAN(X)
 0    0            1            0           
-5    8.71557E-2   0.99619      8.74886E-2  
-10   0.17364      0.9848       0.17632     
-15   0.25881      0.96592      0.26794     
+5    8.71557E-2   0.99619      8.74887E-2  
+10   0.17365      0.98481      0.17633     
+15   0.25882      0.96593      0.26795     
 20   0.34202      0.93969      0.36397     
-25   0.42261      0.9063       0.4663      
-30   0.5          0.86602      0.57735     
-35   0.57357      0.81915      0.7002      
-40   0.64278      0.76604      0.83909     
-45   0.7071       0.7071       1           
-50   0.76604      0.64278      1.19175     
-55   0.81915      0.57357      1.42814     
-60   0.86602      0.49999      1.73205     
-65   0.9063       0.42261      2.1445      
-70   0.93969      0.34202      2.74747     
-75   0.96592      0.25881      3.73205     
-80   0.9848       0.17364      5.67128     
+25   0.42262      0.90631      0.46631     
+30   0.5          0.86603      0.57735     
+35   0.57358      0.81915      0.70021     
+40   0.64279      0.76604      0.8391      
+45   0.70711      0.70711      1           
+50   0.76604      0.64279      1.19175     
+55   0.81915      0.57358      1.42815     
+60   0.86603      0.5          1.73205     
+65   0.90631      0.42262      2.14451     
+70   0.93969      0.34202      2.74748     
+75   0.96593      0.25882      3.73205     
+80   0.98481      0.17365      5.67128     
 85   0.99619      8.71558E-2   11.43004    
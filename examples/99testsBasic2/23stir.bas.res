@@ -1,21 +1,21 @@
 N    FACT(N)      STIR(N)      Accuracy (%)
-1    1            0.92213      7.78629     
-2    2            1.919        4.04977     
-3    6            5.8362       2.72983     
-4    24           23.50617     2.0576      
-5    120          118.01918    1.65067     
+1    1            0.92214      7.7863      
+2    2            1.919        4.04978     
+3    6            5.83621      2.72984     
+4    24           23.50618     2.0576      
+5    120          118.01919    1.65068     
 6    720          710.07824    1.37802     
-7    5040         4980.39453   1.18264     
-8    40320        39902.39843  1.03571     
+7    5040         4980.39453   1.18265     
+8    40320        39902.39843  1.03572     
 9    362880       359537       0.92124     
 10   3628800      3598696.75   0.82956     
-11   3.99168E7    3.96156E7    0.75447     
-12   4.79001E8    4.75687E8    0.69184     
-13   6.22702E9    6.18723E9    0.63888     
-14   8.71782E10   8.66611E10   0.59322     
-15   1.30767E12   1.30043E12   0.55379     
-16   2.09227E13   2.08141E13   0.51938     
+11   3.99168E7    3.96156E7    0.75448     
+12   4.79002E8    4.75688E8    0.69185     
+13   6.22702E9    6.18724E9    0.63888     
+14   8.71783E10   8.66611E10   0.59322     
+15   1.30767E12   1.30043E12   0.5538      
+16   2.09228E13   2.08141E13   0.51939     
 17   3.55687E14   3.53948E14   0.48891     
 18   6.40237E15   6.3728E15    0.46187     
-19   1.21645E17   1.21112E17   0.43767     
-20   2.4329E18    2.42278E18   0.41568     
+19   1.21645E17   1.21113E17   0.43768     
+20   2.4329E18    2.42279E18   0.41569     
@@ -1,9 +1,9 @@
-1234567890 10 1.23456E9 10 0
-1234567890 10 1.23456E9 10 0
-234567890 9 2.34567E8 9 0
-234567890 9 2.34567E8 9 0
-34567890 8 3.45678E7 8 0
-34567890 8 3.45678E7 8 0
+1234567890 10 1.23457E9 10 0
+1234567890 10 1.23457E9 10 0
+234567890 9 2.34568E8 9 0
+234567890 9 2.34568E8 9 0
+34567890 8 3.45679E7 8 0
+34567890 8 3.45679E7 8 0
 4567890 7 4567890 7 0
 4567890 7 4567890 7 0
 567890 6 567890 6 0
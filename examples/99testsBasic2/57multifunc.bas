@@ -19,4 +19,13 @@
 300 REM "Odd stuff"
 310 PRINT "Prints ";: A=FNR(): PRINT "Returns: ",A 
 320 FNQ(9): FNS(11): FNT(13)
+400 REM "Variables created in a function are freed with its argument"
+410 DEF FNG(N)
+420 Y=N+1
+430 RETURN N+X
+440 FEND
+450 X=7: N=3
+460 FOR K=1 TO 3: S=FNT(K)+FNG(K): NEXT
+470 PRINT "K is",K," N is",N," Y is",Y
+480 END
 500 DATA 10
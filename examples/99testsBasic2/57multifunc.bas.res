@@ -5,3 +5,4 @@ This can be done like this as well: 1000
 Or even like this: 1000
 Prints 0
 Returns:  0
+K is 4  N is 3  Y is 0
@@ -1,30 +1,30 @@
 Microsoft mode
-5.74858E-6
+5.74859E-6
 0.36391
 0.2067
 0.14817
-0.50303
-0.76902
+0.50304
+0.76903
 0.68064
-0.1881
+0.18811
 0.51495
 0.92524
 **
-0.92495
+0.92496
 **
-0.92495
-0.92495
-0.92495
-0.92495
-0.92495
-0.92495
-0.92495
-0.92495
-0.92495
-0.92495
+0.92496
+0.92496
+0.92496
+0.92496
+0.92496
+0.92496
+0.92496
+0.92496
+0.92496
+0.92496
 **
-0.18798
-0.36092
+0.18799
+0.36093
 0.2996
 0.59018
 3.52415E-2
@@ -34,13 +34,13 @@ Microsoft mode
 0.34959
 0.94906
 Apple mode
-4.19261
-6.97598
+4.19262
+6.97599
 7.85985
 5.72737
 0.43226
 3.75033E-2
-1.31136
+1.31137
 1.30647
 6.78356
 7.01431
@@ -17,9 +17,9 @@ Decimal test of VAL and @V
 '65536' -> 65536 (@V=5)
 '2147483647' -> 2.14748E9 (@V=10)
 '2147483648' -> 2.14748E9 (@V=10)
-'4294967295' -> 4.29496E9 (@V=10)
-'4294967296' -> 4.29496E9 (@V=10)
-'4294967297' -> 4.29496E9 (@V=10)
+'4294967295' -> 4.29497E9 (@V=10)
+'4294967296' -> 4.29497E9 (@V=10)
+'4294967297' -> 4.29497E9 (@V=10)
 
 
 Hexadecimal test of VAL and @V
@@ -39,13 +39,13 @@ Hexadecimal test of VAL and @V
 '0x-10' -> 0 (@V=2)
 '0xFFFF' -> 65535 (@V=6)
 '0x10000' -> 65536 (@V=7)
-'0xffffFFFF' -> 4.29496E9 (@V=10)
+'0xffffFFFF' -> 4.29497E9 (@V=10)
 '0x7fffffff' -> 2.14748E9 (@V=10)
 '0x80000000' -> 2.14748E9 (@V=10)
 '0x1ffffFFFF' -> 8.58993E9 (@V=11)
-'0x100000000' -> 4.29496E9 (@V=11)
-'0x100000001' -> 4.29496E9 (@V=11)
-'-0x100000000' -> -4.29496E9 (@V=12)
+'0x100000000' -> 4.29497E9 (@V=11)
+'0x100000001' -> 4.29497E9 (@V=11)
+'-0x100000000' -> -4.29497E9 (@V=12)
 
 
 Octal test of VAL and @V
@@ -66,13 +66,13 @@ Octal test of VAL and @V
 '0o-10' -> 0 (@V=2)
 '0o177777' -> 65535 (@V=8)
 '0o200000' -> 65536 (@V=8)
-'0o37777777777' -> 4.29496E9 (@V=13)
+'0o37777777777' -> 4.29497E9 (@V=13)
 '0o17777777777' -> 2.14748E9 (@V=13)
 '0o20000000000' -> 2.14748E9 (@V=13)
 '0o77777777777' -> 8.58993E9 (@V=13)
-'0o40000000000' -> 4.29496E9 (@V=13)
-'0o40000000001' -> 4.29496E9 (@V=13)
-'-0o40000000000' -> -4.29496E9 (@V=14)
+'0o40000000000' -> 4.29497E9 (@V=13)
+'0o40000000001' -> 4.29497E9 (@V=13)
+'-0o40000000000' -> -4.29497E9 (@V=14)
 
 
 Binary test of VAL
@@ -103,10 +103,10 @@ Bit Walking...
 24 = '0b100000000000000000000000' -> 8388608
 25 = '0b1000000000000000000000000' -> 1.67772E7
 26 = '0b10000000000000000000000000' -> 3.35544E7
-27 = '0b100000000000000000000000000' -> 6.71088E7
-28 = '0b1000000000000000000000000000' -> 1.34217E8
+27 = '0b100000000000000000000000000' -> 6.71089E7
+28 = '0b1000000000000000000000000000' -> 1.34218E8
 29 = '0b10000000000000000000000000000' -> 2.68435E8
-30 = '0b100000000000000000000000000000' -> 5.3687E8
+30 = '0b100000000000000000000000000000' -> 5.36871E8
 31 = '0b1000000000000000000000000000000' -> 1.07374E9
 32 = '0b10000000000000000000000000000000' -> 2.14748E9
 '0b10' -> 2 (@V=4)
@@ -126,7 +126,7 @@ Bit Walking...
 '0b1111111111111111' -> 65535 (@V=18)
 '0b10000000000000000' -> 65536 (@V=19)
 Largest binary number in string form (29 bits) for an unmodified string length:
-0b11111111111111111111111111111 -> 5.3687E8 (@V=31)
+0b11111111111111111111111111111 -> 5.36871E8 (@V=31)
 
 
 Testing STR(number, base)
@@ -194,35 +194,35 @@ Testing STR(number, base)
 0 Base 31 -> 0
 0 Base 32 -> 0
 
--2.14748E9 Base 2 -> -1111111111111111111111110000000
--2.14748E9 Base 3 -> -12112122212110120200
--2.14748E9 Base 4 -> -1333333333332000
--2.14748E9 Base 5 -> -13344223433040
--2.14748E9 Base 6 -> -553032005200
--2.14748E9 Base 7 -> -104134210620
--2.14748E9 Base 8 -> -17777777600
--2.14748E9 Base 9 -> -5478773520
+-2.14748E9 Base 2 -> -10000000000000000000000000000000
+-2.14748E9 Base 3 -> -12112122212110202102
+-2.14748E9 Base 4 -> -2000000000000000
+-2.14748E9 Base 5 -> -13344223434043
+-2.14748E9 Base 6 -> -553032005532
+-2.14748E9 Base 7 -> -104134211162
+-2.14748E9 Base 8 -> -20000000000
+-2.14748E9 Base 9 -> -5478773672
 -2.14748E9 Base 10 -> -2.14748E9
--2.14748E9 Base 11 -> -A02220176
--2.14748E9 Base 12 -> -4BB230800
--2.14748E9 Base 13 -> -282BA4A10
--2.14748E9 Base 14 -> -1652CA880
--2.14748E9 Base 15 -> -C87E6630
--2.14748E9 Base 16 -> -7FFFFF80
--2.14748E9 Base 17 -> -53G7F4E0
--2.14748E9 Base 18 -> -3928G3A0
--2.14748E9 Base 19 -> -27C57GF8
--2.14748E9 Base 20 -> -1DB1F8G0
--2.14748E9 Base 21 -> -140H2D30
--2.14748E9 Base 22 -> -IKF5B96
--2.14748E9 Base 23 -> -EBELF3G
--2.14748E9 Base 24 -> -B5GGE00
--2.14748E9 Base 25 -> -8JMDNFK
--2.14748E9 Base 26 -> -6OJ8IK0
--2.14748E9 Base 27 -> -5EHNCFI
--2.14748E9 Base 28 -> -4CLM940
--2.14748E9 Base 29 -> -3HK793P
--2.14748E9 Base 30 -> -2SB6CO0
--2.14748E9 Base 31 -> -2D09U7T
--2.14748E9 Base 32 -> -1VVVVS0
+-2.14748E9 Base 11 -> -A02220282
+-2.14748E9 Base 12 -> -4BB2308A8
+-2.14748E9 Base 13 -> -282BA4AAB
+-2.14748E9 Base 14 -> -1652CA932
+-2.14748E9 Base 15 -> -C87E66B8
+-2.14748E9 Base 16 -> -80000000
+-2.14748E9 Base 17 -> -53G7F549
+-2.14748E9 Base 18 -> -3928G3H2
+-2.14748E9 Base 19 -> -27C57H33
+-2.14748E9 Base 20 -> -1DB1F928
+-2.14748E9 Base 21 -> -140H2D92
+-2.14748E9 Base 22 -> -IKF5BF2
+-2.14748E9 Base 23 -> -EBELF96
+-2.14748E9 Base 24 -> -B5GGE58
+-2.14748E9 Base 25 -> -8JMDNKN
+-2.14748E9 Base 26 -> -6OJ8IOO
+-2.14748E9 Base 27 -> -5EHNCKB
+-2.14748E9 Base 28 -> -4CLM98G
+-2.14748E9 Base 29 -> -3HK7988
+-2.14748E9 Base 30 -> -2SB6CS8
+-2.14748E9 Base 31 -> -2D09UC2
+-2.14748E9 Base 32 -> -2000000
 Done
@@ -0,0 +1,36 @@
+10 REM "MAT statements and array reductions"
+20 REM "MAT A=B+C, A=B-C, A=B*k, A=(k)*B, A=ZER, A=CON, A=B"
+30 REM "SUM(), MIN() and MAX() of an array"
+40 REM "X() is created by MAT with the shape of B()"
+100 DIM A(6), B(6), C(6), M(2,3), N(2,3), P(2,2,2), Q(2,4)
+110 FOR I=1 TO 6: B(I)=I: C(I)=10*I: NEXT
+200 PRINT "Testing element wise operations"
+210 MAT A=B+C: GOSUB 900
+220 MAT A=B-C: GOSUB 900
+230 MAT A=B*3: GOSUB 900
+240 K=2: MAT A=(K+1)*B: GOSUB 900
+250 MAT A=A+A: GOSUB 900
+260 MAT A=CON: GOSUB 900
+270 MAT A=ZER: GOSUB 900
+280 MAT A()=C(): GOSUB 900
+300 PRINT "Testing reductions"
+310 PRINT SUM(B), MIN(C), MAX(C())
+320 B(4)=-5: PRINT SUM(B), MIN(B), MAX(B)
+400 PRINT "Testing two dimensions"
+410 FOR I=1 TO 2: FOR J=1 TO 3: M(I,J)=I*10+J: NEXT: NEXT
+420 MAT N=M*2: PRINT N(1,1), N(2,3), SUM(N)
+430 MAT X=B: PRINT X(4), X(6), SUM(X)
+440 PRINT "Testing three dimensions"
+450 FOR I=1 TO 2: FOR J=1 TO 2: FOR L=1 TO 2: P(I,J,L)=I*100+J*10+L: NEXT: NEXT: NEXT
+460 MAT Y=P: MAT Y=Y+P: PRINT Y(1,2,1), Y(2,1,2), SUM(Y)
+500 PRINT "Testing errors"
+510 ERROR GOTO 600
+520 MAT A=M
+530 PRINT "Not reached"
+600 PRINT "Range error on shape mismatch", ERROR
+610 ERROR GOTO 700
+620 MAT Q=P
+630 PRINT "Not reached"
+700 PRINT "Range error on other dimensions", ERROR
+710 END
+900 FOR I=1 TO 6: PRINT A(I);" ";: NEXT: PRINT: RETURN
@@ -0,0 +1,20 @@
+Testing element wise operations
+11 22 33 44 55 66 
+-9 -18 -27 -36 -45 -54 
+3 6 9 12 15 18 
+3 6 9 12 15 18 
+6 12 18 24 30 36 
+1 1 1 1 1 1 
+0 0 0 0 0 0 
+10 20 30 40 50 60 
+Testing reductions
+21 10 60
+12 -5 6
+Testing two dimensions
+22 46 204
+-5 6 12
+Testing three dimensions
+242 424 2664
+Testing errors
+Range error on shape mismatch 16
+Range error on other dimensions 16
@@ -0,0 +1,22 @@
+10 REM "Arrays with more than two dimensions"
+20 REM "Q() is a 4x4x4 board, R() has four dimensions"
+30 REM "missing indices are the lower limit, like in B(I) of a matrix"
+100 DIM Q(4,4,4), R(2,3,4,5)
+110 FOR I=1 TO 4: FOR J=1 TO 4: FOR K=1 TO 4
+120 Q(I,J,K)=I*100+J*10+K
+130 NEXT: NEXT: NEXT
+200 PRINT "Testing three dimensions"
+210 PRINT Q(1,1,1), Q(2,3,4), Q(4,4,4)
+220 PRINT Q(3,2), Q(3), SUM(Q)
+300 PRINT "Testing four dimensions"
+310 S=0
+320 FOR I=1 TO 2: FOR J=1 TO 3: FOR K=1 TO 4: FOR L=1 TO 5
+330 R(I,J,K,L)=I+J+K+L: S=S+R(I,J,K,L)
+340 NEXT: NEXT: NEXT: NEXT
+350 PRINT S, SUM(R), R(2,3,4,5)
+400 PRINT "Testing two dimensions with more indices"
+410 DIM M(3,4): M(2,3)=7
+420 PRINT M(2,3), M(2,3,1), M(2,3,1,1)
+500 PRINT "An array bigger than the memory is a memory error"
+510 DIM V(128,128,1)
+520 PRINT "not reached"
@@ -0,0 +1,9 @@
+Testing three dimensions
+111 234 444
+321 311 17760
+Testing four dimensions
+1080 1080 14
+Testing two dimensions with more indices
+7 7 7
+An array bigger than the memory is a memory error
+510: Memory Error
@@ -0,0 +1,18 @@
+10 REM "Compact arrays of bytes, 16 bit and 32 bit integers"
+20 REM "DIM BYTE, DIM INT and DIM LONG, the type applies to all arrays"
+30 REM "of the statement, numbers are truncated on assignment"
+100 M=SIZE: DIM A(100): N=SIZE: DIM BYTE B(100): PRINT "Bytes used", M-N, N-SIZE
+110 DIM BYTE C(2,3)
+120 DIM INT I(100)
+130 DIM LONG L(10)
+200 PRINT "Testing the ranges"
+210 B(1)=255: B(2)=0: B(3)=17.9: PRINT B(1), B(2), B(3)
+220 I(1)=-32768: I(2)=32767: I(3)=-5: PRINT I(1), I(2), I(3)
+230 L(1)=-100000: L(2)=123456: PRINT L(1), L(2)
+240 C(2,3)=42: PRINT C(2,3), C(1,1)
+300 PRINT "Testing MAT and the reductions"
+310 FOR J=1 TO 100: A(J)=J*10: NEXT
+320 MAT I=A: PRINT SUM(I), MIN(I), MAX(I)
+330 MAT B=CON: PRINT SUM(B)
+400 PRINT "Testing the range error"
+410 B(1)=256
@@ -0,0 +1,11 @@
+Bytes used 414 114
+Testing the ranges
+255 0 17
+-32768 32767 -5
+-100000 123456
+42 0
+Testing MAT and the reductions
+50500 10 1000
+100
+Testing the range error
+410: Range Error
@@ -0,0 +1,15 @@
+10 REM "Strings that grow and shrink, dynamic strings need the collector"
+20 DIM S$(100,6), U$(100)
+30 N=INT(SIZE/4)-400: DIM Z(N)
+40 FOR I=1 TO 6000
+50 J=I%6+1
+60 IF LEN(S$()(J))>=90 THEN S$()(J)=""
+70 S$()(J)=S$()(J)+CHR$(65+(I/6)%26)
+80 IF I%1000=0 THEN GOSUB 200
+90 NEXT I
+100 A$="Hello": A$(6)=" World": B$=A$(1,5)+A$(6)
+110 PRINT A$, B$, LEN(B$)
+120 END
+200 C=0: FOR J=1 TO 6: U$=S$()(J): FOR K=1 TO LEN(U$): C=C+ASC(U$(K))*K: NEXT K: NEXT J
+210 PRINT I, C, S$()(1)
+220 RETURN
@@ -0,0 +1,7 @@
+1000 1372366 NOPQRSTUVWXYZABCDEFGHIJKLMNOPQRSTUVWXYZABCDEFGHIJKLMNOPQRSTUVWXYZABCDEFGHIJK
+2000 951776 LMNOPQRSTUVWXYZABCDEFGHIJKLMNOPQRSTUVWXYZABCDEFGHIJKLMNOPQRSTUV
+3000 591329 JKLMNOPQRSTUVWXYZABCDEFGHIJKLMNOPQRSTUVWXYZABCDEFG
+4000 317954 HIJKLMNOPQRSTUVWXYZABCDEFGHIJKLMNOPQ
+5000 137836 FGHIJKLMNOPQRSTUVWXYZAB
+6000 24145 DEFGHIJKLM
+Hello World Hello World 11
@@ -0,0 +1,14 @@
+5 REM "Nested string functions work on slices of the original string"
+10 A$="the quick brown fox"
+20 PRINT LEFT$(RIGHT$(A$,9),5)
+30 PRINT MID$(MID$(A$,5,11),7,5)
+40 PRINT RIGHT$(LEFT$(A$,9),5)
+50 PRINT LEFT$("hello world",5)
+60 PRINT MID$(STR$(12345),2,3)
+70 B$=LEFT$(MID$(A$,5),5)+RIGHT$(MID$(A$,1,9),4)
+80 PRINT B$, LEN(B$)
+90 IF LEFT$(MID$(A$,5),5)="quick" THEN PRINT "equal"
+100 PRINT LEFT$(A$(5,9),3)
+110 PRINT LEN(LEFT$(A$,100)), ASC(A$(5))
+120 PRINT VAL(MID$("xx42yy",3,2))+1
+130 PRINT ASC(MID$(A$,5)), ASC(LEFT$(A$,0)), LEN(STR$(-12))
@@ -0,0 +1,11 @@
+brown
+brown
+quick
+hello
+234
+quickuick 9
+equal
+qui
+19 113
+43
+113 0 3
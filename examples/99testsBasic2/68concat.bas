@@ -0,0 +1,15 @@
+10 REM "String additions, A$=A$+X$ appends to A$ in place"
+20 DIM A$(200), B$(200), C$(20)
+30 A$="": FOR I=1 TO 10: A$=A$+STR$(I)+",": NEXT I
+40 PRINT A$, LEN(A$)
+50 B$="ab": C$="cd"
+60 B$=B$+C$+B$(1,1)+"ef"+C$
+70 PRINT B$, LEN(B$)
+80 C$="xyz": C$=C$(2)+C$
+90 PRINT C$
+100 A$="1234567890": A$=A$(1,5)+A$
+110 PRINT A$
+120 A$="": FOR I=1 TO 150: A$=A$+CHR$(65+I%26): NEXT I
+130 PRINT LEN(A$), A$(140)
+140 C$="": C$=C$+C$+"q"+C$
+150 PRINT C$, LEN(C$)
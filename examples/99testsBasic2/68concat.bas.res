@@ -0,0 +1,6 @@
+1,2,3,4,5,6,7,8,9,10, 21
+abcdaefcd 9
+yzyz
+1234512345
+150 KLMNOPQRSTU
+qq 2
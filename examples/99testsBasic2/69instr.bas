@@ -0,0 +1,14 @@
+1 REM "INSTR with strings and start values, string comparison"
+5 DIM A$(60)
+10 A$="the quick brown fox jumps over the lazy dog"
+20 PRINT INSTR(A$,"the"), INSTR(A$,"the",2), INSTR(A$,"dog"), INSTR(A$,"cat")
+30 PRINT INSTR(A$,"g"), INSTR(A$,A$), INSTR(A$,"fox",17), INSTR(A$,"fox",16)
+40 PRINT INSTR("abxb","bb"), INSTR("aab","ab"), INSTR("abc","abcd"), INSTR(A$,"")
+50 PRINT INSTR(A$," "), INSTR(A$,"z"), INSTR("", "a"), INSTR(A$,"o",14)
+60 B$="the": IF A$(1,3)=B$ THEN PRINT "eq1"
+70 IF A$(5,9)="quick" THEN PRINT "eq2"
+80 IF A$="x" THEN PRINT "bad1"
+90 IF B$<>"thE" THEN PRINT "ne1"
+100 C$="": IF C$="" THEN PRINT "eq3"
+110 IF C$<>"" THEN PRINT "bad2"
+120 IF A$<>A$ THEN PRINT "bad3"
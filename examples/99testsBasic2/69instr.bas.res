@@ -0,0 +1,8 @@
+1 32 41 0
+43 1 17 17
+0 2 0 0
+4 38 0 18
+eq1
+eq2
+ne1
+eq3
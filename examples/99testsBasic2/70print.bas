@@ -0,0 +1,14 @@
+10 REM "Strings are printed as blocks, the characters are counted for TAB"
+20 DIM A$(200), B$(40)
+30 A$="hello world"
+40 PRINT A$; TAB(20); "x"
+50 PRINT "abc";: PRINT TAB(10);"d"
+52 SET 11,1
+54 PRINT A$; TAB(20); "x"
+56 PRINT "abc";: PRINT TAB(10);"d"
+58 PRINT "12345"; TAB(3); "y": SET 11,0
+60 FOR I=1 TO 200: A$(I)=CHR$(48+I%10): NEXT I
+70 PRINT A$
+80 OPEN "daten.txt", 1: PRINT &16, A$(1,30); "-"; 42: CLOSE 1
+90 OPEN "daten.txt": INPUT &16, B$: CLOSE 0
+100 PRINT B$, LEN(B$)
@@ -0,0 +1,7 @@
+hello world                    x
+abc          d
+hello world        x
+abc      d
+12345y
+12345678901234567890123456789012345678901234567890123456789012345678901234567890123456789012345678901234567890123456789012345678901234567890123456789012345678901234567890123456789012345678901234567890
+123456789012345678901234567890-42 33
@@ -0,0 +1,14 @@
+5 REM "GOTO and GOSUB after THEN and ELSE"
+10 N=0
+20 FOR I=1 TO 6
+30 IF I%2=0 THEN GOTO 100 ELSE GOSUB 200
+40 NEXT I
+50 PRINT "N ="; N
+60 IF N>0 THEN GOTO 80
+70 PRINT "not reached"
+80 IF N<0 THEN PRINT "no" ELSE GOTO 90
+85 PRINT "not reached"
+90 PRINT "done"
+95 END
+100 N=N+10: GOTO 40
+200 N=N+1: RETURN
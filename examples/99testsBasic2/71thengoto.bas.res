@@ -0,0 +1,2 @@
+N =33
+done
@@ -0,0 +1,15 @@
+5 REM "Constant folding keeps the line numbers after THEN, ELSE, GOTO and GOSUB"
+10 IF 1 THEN 60+10
+20 PRINT "not reached"
+60 PRINT "sixty"
+65 IF 0 THEN 99 ELSE 80+10
+70 PRINT "seventy"
+80 PRINT "eighty": ON 2 GOSUB 200, 200+10, 230
+90 GOTO 100+20: PRINT "x"
+100 PRINT "hundred": END
+120 PRINT "hundred twenty"; 60*60, 2+3*4
+130 IF 1 THEN GOSUB 200+10
+140 END
+200 PRINT "two hundred": RETURN
+210 PRINT "two ten": RETURN
+230 PRINT "two thirty": RETURN
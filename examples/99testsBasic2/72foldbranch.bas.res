@@ -0,0 +1,5 @@
+sixty
+eighty
+two ten
+hundred twenty3600 14
+two ten
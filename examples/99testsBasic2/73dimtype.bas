@@ -0,0 +1,6 @@
+5 REM "A DIM can grow an array but not change its type"
+10 DIM A(10): DIM A(20): A(15)=1: PRINT A(15)
+20 DIM BYTE B(10): DIM BYTE B(20): B(15)=200: PRINT B(15)
+30 C(3)=4: PRINT C(3)
+40 DIM INT D(5,5,2): DIM INT D(6,6,2): D(6,6,2)=-7: PRINT D(6,6,2)
+50 DIM A(10): DIM BYTE A(20)
@@ -0,0 +1,5 @@
+1
+200
+4
+-7
+50: Variable Error
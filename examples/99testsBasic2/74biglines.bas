@@ -0,0 +1,13 @@
+10 REM "A program with more lines than the line index holds"
+20 REM "It is written to a file and then loaded and run"
+100 OPEN "daten.txt", 1
+110 PRINT &16, "10 K=0: S=0"
+120 FOR I=2 TO 4300
+130 IF I%100=0 THEN PRINT &16, I*10; " S=S+1": GOTO 150
+140 PRINT &16, I*10; " REM"
+150 NEXT I
+160 PRINT &16, "43010 K=K+1: IF K<3 THEN GOTO 20"
+170 PRINT &16, "43020 K=9: GOSUB 20000: PRINT S, T: END"
+180 PRINT &16, "20000 IF K=9 THEN T=T+1: RETURN"
+190 CLOSE 1
+200 LOAD "daten.txt"
@@ -0,0 +1 @@
+126 1